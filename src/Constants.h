@@ -11,91 +11,98 @@ const char* INITPATCHNAME = "Initial Patch";
 #define HOLD_DURATION 1000
 const uint32_t CLICK_DURATION = 250;
 #define PATCHES_LIMIT 999
+#define DEBUG_CHECKS 0  // 1 adds self-checks and timing logs on Serial
 String INITPATCH = "A Piano, 1, 1, 0, 1, 1, 1, 1, 1, 1, 0, 1, 2, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 0";
 
 // Create and populate the array with data
 
-// Factory Patch nibbles
-const String factorynibbles[80] = {
-"Fat Brass,  0A, 0C, 04, 00, 09, 0A, 00, 04, 03, 0D, 01, 0D, 00, 00, 04, 00, 09, 00, 02, 07, 06, 00, 05, 0B",
-"Bowed Strings,  0B, 0D, 0C, 0E, 0C, 05, 03, 0D, 0C, 05, 00, 0E, 01, 08, 04, 00, 0A, 00, 06, 00, 02, 08, 0D, 0C", 
-"Synth Clav,  00, 00, 0C, 00, 09, 0A, 00, 04, 0C, 08, 03, 08, 03, 09, 00, 00, 09, 00, 02, 07, 00, 00, 05, 0B", 
-"Vibes Piano,  00, 00, 0D, 0A, 00, 00, 0D, 0E, 09, 03, 03, 08, 00, 00, 00, 03, 06, 07, 09, 0B, 00, 08, 0D, 08", 
-"Perc Organ,  08, 00, 08, 0D, 09, 0A, 00, 04, 0B, 07, 05, 04, 01, 08, 00, 00, 03, 00, 01, 0F, 00, 00, 05, 05", 
-"Funk Bass,  0A, 05, 0C, 00, 0D, 09, 01, 0D, 09, 0A, 06, 01, 01, 08, 00, 00, 0F, 00, 01, 0C, 00, 00, 00, 0F", 
-"Flute,  0A, 0C, 0C, 0E, 05, 02, 0C, 0A, 08, 0D, 04, 05, 01, 08, 02, 03, 0A, 00, 09, 03, 03, 00, 0D, 0C", 
-"Helicopter,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Brass 5ths,  0A, 0C, 05, 04, 0B, 0F, 04, 04, 00, 04, 00, 0E, 00, 00, 02, 00, 09, 07, 05, 07, 06, 08, 0D, 0B", 
-"Soft Strings,  05, 06, 0C, 0E, 0C, 05, 04, 04, 0B, 0F, 00, 01, 02, 08, 05, 00, 0A, 00, 02, 00, 02, 00, 0D, 0C", 
-"Synth Piano,  08, 00, 0C, 0E, 02, 0D, 0C, 0A, 09, 07, 00, 01, 01, 01, 00, 00, 05, 00, 02, 04, 00, 00, 0D, 07", 
-"Steel Flute,  00, 00, 0A, 01, 00, 00, 0B, 07, 0B, 08, 04, 05, 02, 08, 00, 00, 09, 00, 05, 0A, 00, 08, 05, 0B", 
-"New W Organ,  00, 00, 0D, 0A, 02, 0D, 0B, 00, 08, 07, 01, 0D, 00, 00, 05, 00, 0C, 00, 08, 0F, 00, 00, 05, 0E", 
-"Celeste,  08, 07, 0C, 0E, 05, 02, 0D, 0E, 08, 0A, 04, 05, 01, 08, 02, 03, 07, 00, 09, 0B, 03, 00, 0D, 09", 
-"Pipe Organ,  0A, 05, 05, 04, 0C, 05, 04, 04, 03, 0F, 01, 0D, 00, 00, 00, 00, 09, 00, 09, 01, 00, 00, 0D, 0B", 
-"Synth Sweep,  0B, 0D, 06, 01, 08, 00, 06, 03, 08, 04, 06, 01, 00, 00, 00, 00, 09, 00, 06, 07, 00, 08, 0D, 0B", 
-"Solo Brass,  0A, 05, 05, 0A, 02, 0D, 03, 0D, 08, 04, 01, 0D, 00, 00, 05, 00, 09, 00, 05, 0F, 02, 08, 0D, 0B", 
-"Horns,  0A, 0C, 04, 0E, 04, 0C, 04, 04, 00, 02, 00, 0E, 00, 00, 01, 02, 09, 00, 01, 0D, 02, 00, 0D, 0B", 
-"Fat Brass,  0D, 06, 04, 00, 09, 0A, 00, 04, 03, 0D, 01, 0D, 00, 00, 04, 00, 09, 00, 02, 07, 06, 00, 05, 0B", 
-"Brass Oct,  0A, 0C, 04, 07, 0C, 05, 04, 04, 08, 04, 00, 01, 00, 00, 05, 00, 09, 00, 01, 06, 02, 08, 0D, 0B", 
-"Pic Trumpet,  0A, 05, 05, 0A, 02, 0D, 03, 0D, 08, 00, 00, 01, 00, 00, 05, 00, 09, 00, 09, 0E, 03, 00, 0D, 0B", 
-"Obi Wah,  0A, 0C, 05, 04, 0B, 09, 04, 0A, 08, 02, 05, 04, 00, 00, 05, 00, 09, 00, 05, 0D, 02, 08, 0D, 0B", 
-"Synth Brass,  0C, 03, 04, 00, 09, 0A, 03, 00, 03, 05, 04, 05, 00, 00, 04, 00, 09, 00, 02, 07, 06, 00, 05, 0B", 
-"Purc Brass, 0A, 0C, 03, 0A, 0B, 09, 00, 04, 00, 04, 02, 0A, 00, 00, 04, 00, 09, 00, 02, 07, 06, 00, 05, 0B", 
-"High Strings,  0B, 0D, 0C, 0E, 0C, 05, 03, 0D, 0C, 05, 00, 0E, 01, 08, 04, 00, 0A, 00, 0A, 01, 0B, 00, 0D, 0C", 
-"Low Strings,  0B, 0D, 04, 0E, 0C, 05, 03, 0D, 0C, 02, 01, 0D, 00, 00, 04, 00, 0A, 00, 02, 00, 02, 00, 0D, 0C", 
-"Bowed Violins,  0B, 08, 00, 00, 0D, 02, 03, 07, 0C, 04, 00, 01, 00, 00, 00, 00, 09, 00, 05, 08, 00, 08, 0D, 0B", 
-"Sforzando St, 0B, 0D, 03, 0A, 08, 0D, 03, 0D, 0B, 0F, 01, 0D, 00, 00, 04, 00, 07, 00, 02, 00, 02, 00, 0D, 09", 
-"Pizz Strings,  08, 00, 0B, 02, 08, 00, 03, 07, 0A, 09, 00, 0E, 01, 08, 00, 00, 0A, 00, 06, 06, 00, 08, 0D, 0C", 
-"Solo Violin,  0B, 0D, 03, 0A, 03, 09, 03, 0D, 0C, 00, 00, 01, 00, 00, 04, 00, 09, 00, 05, 09, 02, 08, 0D, 0B", 
-"SQ Ensemble,  0B, 0D, 0C, 00, 03, 02, 0C, 04, 06, 03, 00, 01, 01, 08, 00, 00, 0A, 00, 06, 00, 00, 08, 0D, 0C", 
-"Lunar Flute,  0B, 0D, 04, 0E, 0A, 07, 05, 01, 0B, 01, 06, 01, 00, 00, 04, 02, 0A, 00, 06, 00, 02, 08, 0D, 0C", 
-"Clav,  00, 00, 0C, 00, 00, 00, 00, 04, 05, 00, 01, 0D, 03, 09, 00, 00, 09, 00, 01, 0D, 00, 00, 05, 0B", 
-"Harpsichord,  00, 00, 0C, 07, 00, 07, 02, 0A, 05, 03, 00, 01, 03, 00, 00, 00, 09, 00, 05, 01, 00, 08, 0D, 0B", 
-"Pluck Synth,  09, 02, 02, 0E, 09, 0A, 00, 04, 03, 05, 00, 0E, 00, 00, 04, 00, 09, 00, 02, 07, 06, 00, 05, 0B", 
-"Bright Piano,  08, 00, 04, 07, 0A, 00, 03, 0D, 03, 05, 02, 0A, 00, 00, 00, 00, 09, 00, 05, 09, 00, 08, 0D, 0B", 
-"Sinful Eyes,  08, 0C, 0D, 04, 0A, 00, 04, 0A, 04, 02, 00, 01, 03, 00, 00, 00, 02, 00, 02, 07, 00, 00, 0D, 03", 
-"Vibes,  00, 00, 0D, 0A, 00, 00, 0D, 0E, 09, 0F, 02, 0A, 01, 01, 00, 06, 07, 00, 09, 02, 00, 00, 0D, 09", 
-"Reed Piano,  00, 00, 0D, 0A, 00, 0D, 0B, 0D, 09, 05, 00, 0E, 02, 08, 00, 00, 09, 00, 05, 04, 00, 00, 0D, 0B", 
-"Jazz Guitar,  00, 0C, 0C, 0E, 01, 0A, 03, 07, 0A, 04, 00, 01, 01, 01, 00, 00, 09, 00, 01, 0A, 00, 00, 0D, 0B", 
-"Organ 1,  08, 00, 00, 00, 00, 00, 08, 04, 0B, 0D, 05, 04, 00, 00, 00, 00, 09, 07, 05, 01, 00, 00, 05, 0B", 
-"Organ 2,  08, 00, 00, 00, 08, 00, 00, 04, 0B, 07, 05, 04, 00, 00, 00, 00, 09, 00, 05, 09, 00, 08, 05, 0B", 
-"Organ 3,  08, 00, 08, 00, 09, 0A, 00, 04, 0A, 09, 04, 05, 01, 08, 00, 00, 03, 00, 01, 07, 00, 08, 05, 05", 
-"Chimeschord,  00, 00, 0C, 0E, 00, 00, 0B, 07, 04, 00, 02, 0A, 00, 08, 00, 00, 09, 07, 09, 00, 00, 00, 0D, 0B", 
-"Steel Drums,  01, 02, 0B, 0A, 0B, 09, 04, 0A, 0A, 0F, 00, 01, 01, 01, 00, 00, 09, 00, 06, 0B, 00, 00, 0D, 0B", 
-"Accordian,  0B, 01, 0A, 07, 06, 00, 0B, 0D, 06, 03, 00, 01, 02, 02, 00, 00, 0B, 00, 05, 08, 00, 08, 0D, 0D", 
-"Harmonica,  02, 0C, 0D, 04, 08, 00, 03, 00, 0B, 02, 02, 0A, 02, 08, 02, 06, 09, 00, 09, 01, 03, 00, 0D, 0B", 
-"Sax Ensemble,  02, 0C, 0D, 04, 0B, 09, 04, 04, 00, 07, 00, 01, 01, 08, 07, 00, 09, 00, 05, 0E, 02, 08, 0D, 0B", 
-"Space Cath,  0A, 00, 02, 01, 03, 09, 0E, 03, 0B, 0D, 06, 01, 00, 00, 00, 03, 09, 07, 09, 08, 06, 00, 08, 09", 
-"Honkey Tonk,  00, 00, 0C, 00, 09, 0A, 04, 04, 03, 0D, 02, 0A, 01, 08, 00, 00, 09, 00, 07, 01, 00, 08, 0D, 0B", 
-"Space Voice,  0B, 0D, 04, 0E, 0A, 07, 05, 01, 0B, 01, 06, 01, 00, 00, 07, 00, 07, 03, 06, 00, 00, 08, 0D, 09", 
-"Music Box,  08, 00, 05, 04, 08, 00, 05, 07, 0A, 00, 03, 08, 00, 00, 00, 00, 09, 07, 0A, 09, 01, 00, 0D, 0B", 
-"Grunge,  0D, 01, 0E, 01, 08, 00, 06, 03, 08, 07, 06, 01, 02, 02, 05, 00, 09, 03, 02, 07, 02, 00, 0D, 0B", 
-"Synth Gong,  09, 02, 0D, 04, 08, 00, 05, 07, 0B, 0B, 06, 01, 03, 09, 00, 00, 09, 05, 07, 00, 00, 00, 08, 09", 
-"Break Up,  00, 00, 0E, 01, 00, 00, 0E, 03, 08, 00, 06, 01, 00, 00, 0E, 0E, 0F, 05, 0A, 07, 06, 00, 0E, 09", 
-"Ompah Brass,  0A, 0C, 05, 0A, 0A, 0D, 03, 0D, 08, 08, 00, 0E, 00, 00, 05, 00, 09, 00, 03, 07, 02, 00, 0D, 0B", 
-"Patch 57,  0A, 0C, 04, 00, 09, 0A, 00, 04, 03, 0D, 01, 0D, 00, 00, 04, 00, 09, 00, 02, 07, 06, 00, 05, 0B", 
-"Patch 58,  0B, 0D, 0C, 0E, 0C, 05, 03, 0D, 0C, 05, 00, 0E, 01, 08, 04, 00, 0A, 00, 06, 00, 02, 08, 0D, 0C", 
-"Patch 59,  00, 00, 0C, 00, 09, 0A, 00, 04, 0C, 08, 03, 08, 03, 09, 00, 00, 09, 00, 02, 07, 00, 00, 05, 0B", 
-"Patch 60,  00, 00, 0D, 0A, 00, 00, 0D, 0E, 09, 03, 03, 08, 00, 00, 00, 03, 06, 07, 09, 0B, 00, 08, 0D, 08", 
-"Patch 61,  08, 00, 08, 0D, 09, 0A, 00, 04, 0B, 07, 05, 04, 01, 08, 00, 00, 03, 00, 01, 0F, 00, 00, 05, 05", 
-"Patch 62,  0A, 05, 0C, 00, 0D, 09, 01, 0D, 09, 0A, 06, 01, 01, 08, 00, 00, 0F, 00, 01, 0C, 00, 00, 00, 0F", 
-"Patch 63,  0A, 0C, 0C, 0E, 05, 02, 0C, 0A, 08, 0D, 04, 05, 01, 08, 02, 03, 0A, 00, 09, 03, 03, 00, 0D, 0C", 
-"Patch 64,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 65,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 66,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 67,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 68,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 69,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 70,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 71,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 72,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 73,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 74,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 75,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 76,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 77,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 78,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 79,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
-"Patch 80,  0D, 06, 06, 01, 09, 04, 06, 03, 01, 07, 02, 0A, 00, 00, 00, 0E, 0F, 00, 02, 03, 00, 00, 0E, 09", 
+// Factory patches, name and the 12 packed Poly-61 bytes, kept in flash
+struct FactoryPatch
+{
+  char name[14];
+  uint8_t packed[PATCH_BYTES];
+};
+
+const FactoryPatch factoryPatches[80] PROGMEM = {
+  { "Fat Brass", { 0xAC, 0x40, 0x9A, 0x04, 0x3D, 0x1D, 0x00, 0x40, 0x90, 0x27, 0x60, 0x5B } },
+  { "Bowed Strings", { 0xBD, 0xCE, 0xC5, 0x3D, 0xC5, 0x0E, 0x18, 0x40, 0xA0, 0x60, 0x28, 0xDC } },
+  { "Synth Clav", { 0x00, 0xC0, 0x9A, 0x04, 0xC8, 0x38, 0x39, 0x00, 0x90, 0x27, 0x00, 0x5B } },
+  { "Vibes Piano", { 0x00, 0xDA, 0x00, 0xDE, 0x93, 0x38, 0x00, 0x03, 0x67, 0x9B, 0x08, 0xD8 } },
+  { "Perc Organ", { 0x80, 0x8D, 0x9A, 0x04, 0xB7, 0x54, 0x18, 0x00, 0x30, 0x1F, 0x00, 0x55 } },
+  { "Funk Bass", { 0xA5, 0xC0, 0xD9, 0x1D, 0x9A, 0x61, 0x18, 0x00, 0xF0, 0x1C, 0x00, 0x0F } },
+  { "Flute", { 0xAC, 0xCE, 0x52, 0xCA, 0x8D, 0x45, 0x18, 0x23, 0xA0, 0x93, 0x30, 0xDC } },
+  { "Helicopter", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Brass 5ths", { 0xAC, 0x54, 0xBF, 0x44, 0x04, 0x0E, 0x00, 0x20, 0x97, 0x57, 0x68, 0xDB } },
+  { "Soft Strings", { 0x56, 0xCE, 0xC5, 0x44, 0xBF, 0x01, 0x28, 0x50, 0xA0, 0x20, 0x20, 0xDC } },
+  { "Synth Piano", { 0x80, 0xCE, 0x2D, 0xCA, 0x97, 0x01, 0x11, 0x00, 0x50, 0x24, 0x00, 0xD7 } },
+  { "Steel Flute", { 0x00, 0xA1, 0x00, 0xB7, 0xB8, 0x45, 0x28, 0x00, 0x90, 0x5A, 0x08, 0x5B } },
+  { "New W Organ", { 0x00, 0xDA, 0x2D, 0xB0, 0x87, 0x1D, 0x00, 0x50, 0xC0, 0x8F, 0x00, 0x5E } },
+  { "Celeste", { 0x87, 0xCE, 0x52, 0xDE, 0x8A, 0x45, 0x18, 0x23, 0x70, 0x9B, 0x30, 0xD9 } },
+  { "Pipe Organ", { 0xA5, 0x54, 0xC5, 0x44, 0x3F, 0x1D, 0x00, 0x00, 0x90, 0x91, 0x00, 0xDB } },
+  { "Synth Sweep", { 0xBD, 0x61, 0x80, 0x63, 0x84, 0x61, 0x00, 0x00, 0x90, 0x67, 0x08, 0xDB } },
+  { "Solo Brass", { 0xA5, 0x5A, 0x2D, 0x3D, 0x84, 0x1D, 0x00, 0x50, 0x90, 0x5F, 0x28, 0xDB } },
+  { "Horns", { 0xAC, 0x4E, 0x4C, 0x44, 0x02, 0x0E, 0x00, 0x12, 0x90, 0x1D, 0x20, 0xDB } },
+  { "Fat Brass", { 0xD6, 0x40, 0x9A, 0x04, 0x3D, 0x1D, 0x00, 0x40, 0x90, 0x27, 0x60, 0x5B } },
+  { "Brass Oct", { 0xAC, 0x47, 0xC5, 0x44, 0x84, 0x01, 0x00, 0x50, 0x90, 0x16, 0x28, 0xDB } },
+  { "Pic Trumpet", { 0xA5, 0x5A, 0x2D, 0x3D, 0x80, 0x01, 0x00, 0x50, 0x90, 0x9E, 0x30, 0xDB } },
+  { "Obi Wah", { 0xAC, 0x54, 0xB9, 0x4A, 0x82, 0x54, 0x00, 0x50, 0x90, 0x5D, 0x28, 0xDB } },
+  { "Synth Brass", { 0xC3, 0x40, 0x9A, 0x30, 0x35, 0x45, 0x00, 0x40, 0x90, 0x27, 0x60, 0x5B } },
+  { "Purc Brass", { 0xAC, 0x3A, 0xB9, 0x04, 0x04, 0x2A, 0x00, 0x40, 0x90, 0x27, 0x60, 0x5B } },
+  { "High Strings", { 0xBD, 0xCE, 0xC5, 0x3D, 0xC5, 0x0E, 0x18, 0x40, 0xA0, 0xA1, 0xB0, 0xDC } },
+  { "Low Strings", { 0xBD, 0x4E, 0xC5, 0x3D, 0xC2, 0x1D, 0x00, 0x40, 0xA0, 0x20, 0x20, 0xDC } },
+  { "Bowed Violins", { 0xB8, 0x00, 0xD2, 0x37, 0xC4, 0x01, 0x00, 0x00, 0x90, 0x58, 0x08, 0xDB } },
+  { "Sforzando St", { 0xBD, 0x3A, 0x8D, 0x3D, 0xBF, 0x1D, 0x00, 0x40, 0x70, 0x20, 0x20, 0xD9 } },
+  { "Pizz Strings", { 0x80, 0xB2, 0x80, 0x37, 0xA9, 0x0E, 0x18, 0x00, 0xA0, 0x66, 0x08, 0xDC } },
+  { "Solo Violin", { 0xBD, 0x3A, 0x39, 0x3D, 0xC0, 0x01, 0x00, 0x40, 0x90, 0x59, 0x28, 0xDB } },
+  { "SQ Ensemble", { 0xBD, 0xC0, 0x32, 0xC4, 0x63, 0x01, 0x18, 0x00, 0xA0, 0x60, 0x08, 0xDC } },
+  { "Lunar Flute", { 0xBD, 0x4E, 0xA7, 0x51, 0xB1, 0x61, 0x00, 0x42, 0xA0, 0x60, 0x28, 0xDC } },
+  { "Clav", { 0x00, 0xC0, 0x00, 0x04, 0x50, 0x1D, 0x39, 0x00, 0x90, 0x1D, 0x00, 0x5B } },
+  { "Harpsichord", { 0x00, 0xC7, 0x07, 0x2A, 0x53, 0x01, 0x30, 0x00, 0x90, 0x51, 0x08, 0xDB } },
+  { "Pluck Synth", { 0x92, 0x2E, 0x9A, 0x04, 0x35, 0x0E, 0x00, 0x40, 0x90, 0x27, 0x60, 0x5B } },
+  { "Bright Piano", { 0x80, 0x47, 0xA0, 0x3D, 0x35, 0x2A, 0x00, 0x00, 0x90, 0x59, 0x08, 0xDB } },
+  { "Sinful Eyes", { 0x8C, 0xD4, 0xA0, 0x4A, 0x42, 0x01, 0x30, 0x00, 0x20, 0x27, 0x00, 0xD3 } },
+  { "Vibes", { 0x00, 0xDA, 0x00, 0xDE, 0x9F, 0x2A, 0x11, 0x06, 0x70, 0x92, 0x00, 0xD9 } },
+  { "Reed Piano", { 0x00, 0xDA, 0x0D, 0xBD, 0x95, 0x0E, 0x28, 0x00, 0x90, 0x54, 0x00, 0xDB } },
+  { "Jazz Guitar", { 0x0C, 0xCE, 0x1A, 0x37, 0xA4, 0x01, 0x11, 0x00, 0x90, 0x1A, 0x00, 0xDB } },
+  { "Organ 1", { 0x80, 0x00, 0x00, 0x84, 0xBD, 0x54, 0x00, 0x00, 0x97, 0x51, 0x00, 0x5B } },
+  { "Organ 2", { 0x80, 0x00, 0x80, 0x04, 0xB7, 0x54, 0x00, 0x00, 0x90, 0x59, 0x08, 0x5B } },
+  { "Organ 3", { 0x80, 0x80, 0x9A, 0x04, 0xA9, 0x45, 0x18, 0x00, 0x30, 0x17, 0x08, 0x55 } },
+  { "Chimeschord", { 0x00, 0xCE, 0x00, 0xB7, 0x40, 0x2A, 0x08, 0x00, 0x97, 0x90, 0x00, 0xDB } },
+  { "Steel Drums", { 0x12, 0xBA, 0xB9, 0x4A, 0xAF, 0x01, 0x11, 0x00, 0x90, 0x6B, 0x00, 0xDB } },
+  { "Accordian", { 0xB1, 0xA7, 0x60, 0xBD, 0x63, 0x01, 0x22, 0x00, 0xB0, 0x58, 0x08, 0xDD } },
+  { "Harmonica", { 0x2C, 0xD4, 0x80, 0x30, 0xB2, 0x2A, 0x28, 0x26, 0x90, 0x91, 0x30, 0xDB } },
+  { "Sax Ensemble", { 0x2C, 0xD4, 0xB9, 0x44, 0x07, 0x01, 0x18, 0x70, 0x90, 0x5E, 0x28, 0xDB } },
+  { "Space Cath", { 0xA0, 0x21, 0x39, 0xE3, 0xBD, 0x61, 0x00, 0x03, 0x97, 0x98, 0x60, 0x89 } },
+  { "Honkey Tonk", { 0x00, 0xC0, 0x9A, 0x44, 0x3D, 0x2A, 0x18, 0x00, 0x90, 0x71, 0x08, 0xDB } },
+  { "Space Voice", { 0xBD, 0x4E, 0xA7, 0x51, 0xB1, 0x61, 0x00, 0x70, 0x73, 0x60, 0x08, 0xD9 } },
+  { "Music Box", { 0x80, 0x54, 0x80, 0x57, 0xA0, 0x38, 0x00, 0x00, 0x97, 0xA9, 0x10, 0xDB } },
+  { "Grunge", { 0xD1, 0xE1, 0x80, 0x63, 0x87, 0x61, 0x22, 0x50, 0x93, 0x27, 0x20, 0xDB } },
+  { "Synth Gong", { 0x92, 0xD4, 0x80, 0x57, 0xBB, 0x61, 0x39, 0x00, 0x95, 0x70, 0x00, 0x89 } },
+  { "Break Up", { 0x00, 0xE1, 0x00, 0xE3, 0x80, 0x61, 0x00, 0xEE, 0xF5, 0xA7, 0x60, 0xE9 } },
+  { "Ompah Brass", { 0xAC, 0x5A, 0xAD, 0x3D, 0x88, 0x0E, 0x00, 0x50, 0x90, 0x37, 0x20, 0xDB } },
+  { "Patch 57", { 0xAC, 0x40, 0x9A, 0x04, 0x3D, 0x1D, 0x00, 0x40, 0x90, 0x27, 0x60, 0x5B } },
+  { "Patch 58", { 0xBD, 0xCE, 0xC5, 0x3D, 0xC5, 0x0E, 0x18, 0x40, 0xA0, 0x60, 0x28, 0xDC } },
+  { "Patch 59", { 0x00, 0xC0, 0x9A, 0x04, 0xC8, 0x38, 0x39, 0x00, 0x90, 0x27, 0x00, 0x5B } },
+  { "Patch 60", { 0x00, 0xDA, 0x00, 0xDE, 0x93, 0x38, 0x00, 0x03, 0x67, 0x9B, 0x08, 0xD8 } },
+  { "Patch 61", { 0x80, 0x8D, 0x9A, 0x04, 0xB7, 0x54, 0x18, 0x00, 0x30, 0x1F, 0x00, 0x55 } },
+  { "Patch 62", { 0xA5, 0xC0, 0xD9, 0x1D, 0x9A, 0x61, 0x18, 0x00, 0xF0, 0x1C, 0x00, 0x0F } },
+  { "Patch 63", { 0xAC, 0xCE, 0x52, 0xCA, 0x8D, 0x45, 0x18, 0x23, 0xA0, 0x93, 0x30, 0xDC } },
+  { "Patch 64", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 65", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 66", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 67", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 68", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 69", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 70", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 71", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 72", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 73", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 74", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 75", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 76", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 77", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 78", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 79", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
+  { "Patch 80", { 0xD6, 0x61, 0x94, 0x63, 0x17, 0x2A, 0x00, 0x0E, 0xF0, 0x23, 0x00, 0xE9 } },
 };
 
@@ -0,0 +1,210 @@
+// Edit journal
+// Panel edits made since the last recall or save are journalled to the card so a power cut
+// doesn't lose them. loop() compares the parameters against a shadow copy each pass and adds
+// a (parameter, value, time) entry to a RAM buffer for every change, so the encoder and MIDI
+// paths never see the journal. An unflushed entry for the same parameter is overwritten in
+// place, which keeps the buffer at one entry per parameter however fast the encoder turns.
+// The storage task appends the buffer to EDIT_JOURNAL_FILE once edits stop for
+// EDIT_JOURNAL_IDLE_FLUSH, or at least every EDIT_JOURNAL_FLUSH_INTERVAL while they don't.
+// A recall or save starts the file over with a base entry naming the patch the edits apply
+// to, and past EDIT_JOURNAL_MAX_SIZE it is compacted to the base plus one entry per changed
+// parameter. At boot the journal is replayed over its base patch.
+#define EDIT_JOURNAL_FILE PATCH_LIB_DIR "/EDITS.JNL"
+#define EDIT_JOURNAL_PARAMS 32
+#define EDIT_JOURNAL_IDLE_FLUSH 500
+#define EDIT_JOURNAL_FLUSH_INTERVAL 2000
+#define EDIT_JOURNAL_MAX_SIZE 4096
+#define EDIT_JOURNAL_BASE 0xFF  // param of the entry starting a journal, value is the patch number
+
+struct EditJournalEntry
+{
+  uint8_t param;
+  uint8_t page;  // Library page, base entry only
+  int16_t value;
+  uint32_t time;  // millis() when the edit was made
+};
+
+int *const *journalParams = nullptr;
+int journalParamCount = 0;
+int journalShadow[EDIT_JOURNAL_PARAMS];  // Values seen on the last pass
+int journalBase[EDIT_JOURNAL_PARAMS];    // Values of the base patch
+int journalBasePatch = 0;
+
+// Shared with the storage task, guarded by lockStorage()
+EditJournalEntry journalBuffer[EDIT_JOURNAL_PARAMS + 1];
+int journalCount = 0;
+bool journalRewrite = false;  // Truncate the file before writing the buffer
+volatile uint32_t journalFileSize = 0;
+volatile bool journalWriteFailed = false;
+
+bool journalFlushQueued = false;
+bool journalImporting = false;
+unsigned long journalLastEdit = 0;
+unsigned long journalLastFlush = 0;
+
+// Call once with the parameter table before the first recall
+void beginEditJournal(int *const *params, int count) {
+  journalParams = params;
+  journalParamCount = count < EDIT_JOURNAL_PARAMS ? count : EDIT_JOURNAL_PARAMS;
+}
+
+void addJournalEntry(uint8_t param, int value) {
+  for (int i = 0; i < journalCount; i++) {
+    if (journalBuffer[i].param == param) {
+      journalBuffer[i].value = value;
+      journalBuffer[i].time = millis();
+      return;
+    }
+  }
+  journalBuffer[journalCount++] = { param, 0, (int16_t)value, (uint32_t)millis() };
+}
+
+// Replaces whatever is buffered with a fresh file holding the base and every parameter that
+// differs from it. Must be called with the storage lock held.
+void rewriteJournal() {
+  journalCount = 0;
+  journalBuffer[journalCount++] = { EDIT_JOURNAL_BASE, (uint8_t)patchPage, (int16_t)journalBasePatch, (uint32_t)millis() };
+  for (int i = 0; i < journalParamCount; i++) {
+    if (journalShadow[i] != journalBase[i]) addJournalEntry(i, journalShadow[i]);
+  }
+  journalRewrite = true;
+}
+
+// The current parameters become the base, called after a recall or save
+void startEditJournal(int patchNo) {
+  if (!journalParams) return;
+  for (int i = 0; i < journalParamCount; i++) {
+    journalShadow[i] = journalBase[i] = *journalParams[i];
+  }
+  journalBasePatch = patchNo;
+  lockStorage();
+  rewriteJournal();
+  unlockStorage();
+}
+
+// Runs on the storage task
+bool flushEditJournal() {
+  static EditJournalEntry entries[EDIT_JOURNAL_PARAMS + 1];
+  lockStorage();
+  int count = journalCount;
+  bool rewrite = journalRewrite;
+  memcpy(entries, journalBuffer, count * sizeof(EditJournalEntry));
+  journalCount = 0;
+  journalRewrite = false;
+  unlockStorage();
+
+  File file = SD.open(EDIT_JOURNAL_FILE, rewrite ? FILE_WRITE : FILE_APPEND);
+  size_t len = count * sizeof(EditJournalEntry);
+  bool ok = file && file.write((const uint8_t *)entries, len) == len;
+  if (file) {
+    journalFileSize = file.size();
+    file.close();
+  }
+  if (!ok) journalWriteFailed = true;  // loop() rewrites the whole journal next time
+  return ok;
+}
+
+void editJournalFlushed() {
+  journalFlushQueued = false;
+}
+
+// Called after patchNo is deleted and every later patch has moved down one number. Edits made
+// on the deleted patch are dropped, edits on a later one follow it to its new number.
+void editJournalPatchDeleted(int patchNo) {
+  if (!journalParams || journalBasePatch < patchNo) return;
+  if (journalBasePatch == patchNo) {
+    journalBasePatch = 0;
+    memcpy(journalBase, journalShadow, sizeof(journalBase));  // Nothing left to replay
+  } else {
+    journalBasePatch--;
+  }
+  lockStorage();
+  rewriteJournal();
+  unlockStorage();
+}
+
+// Called from loop()
+void serviceEditJournal() {
+  if (!journalParams || !patchCardPresent || recallPatchFlag) return;
+  // Imports decode each patch into the parameters. The batch covers a whole bank, gaps between
+  // 0x03 messages included, and closes itself if the dump is cut short.
+  if (receivingSysEx || patchBatchOpen) {
+    journalImporting = true;
+    return;
+  }
+  if (journalImporting) {  // Whatever the import left in the parameters isn't an edit
+    journalImporting = false;
+    for (int i = 0; i < journalParamCount; i++) journalShadow[i] = *journalParams[i];
+  }
+  unsigned long now = millis();
+  bool edited = false;
+  for (int i = 0; i < journalParamCount; i++) {
+    int value = *journalParams[i];
+    if (value == journalShadow[i]) continue;
+    journalShadow[i] = value;
+    if (!edited) lockStorage();
+    edited = true;
+    addJournalEntry(i, value);
+  }
+  if (edited) {
+    unlockStorage();
+    journalLastEdit = now;
+  }
+
+  if (journalFlushQueued) return;
+  if (journalWriteFailed || journalFileSize > EDIT_JOURNAL_MAX_SIZE) {
+    journalWriteFailed = false;
+    journalFileSize = 0;
+    lockStorage();
+    rewriteJournal();
+    unlockStorage();
+  }
+  if (journalCount == 0) return;  // Only loop() adds entries, so no lock needed to peek
+  if (now - journalLastEdit < EDIT_JOURNAL_IDLE_FLUSH && now - journalLastFlush < EDIT_JOURNAL_FLUSH_INTERVAL) return;
+  journalLastFlush = now;
+  journalFlushQueued = true;
+  queueStorage(STORAGE_WRITE_JOURNAL, 0, editJournalFlushed);
+}
+
+// Patch the journal left by the last session was started from, 0 if there is none or it
+// belongs to another library page
+int editJournalPatch() {
+  if (!patchCardPresent) return 0;
+  File file = SD.open(EDIT_JOURNAL_FILE);
+  if (!file) return 0;
+  EditJournalEntry base;
+  bool ok = file.read((uint8_t *)&base, sizeof(base)) == sizeof(base);
+  file.close();
+  if (!ok || base.param != EDIT_JOURNAL_BASE || base.page != patchPage) return 0;
+  return base.value;
+}
+
+// Applies the journalled edits over patchNo once it has been recalled, returns the number of
+// parameters changed. The edits stay journalled, the next flush writes them after the new base.
+int replayEditJournal(int patchNo) {
+  if (!journalParams || patchNo == 0 || editJournalPatch() != patchNo) return 0;
+  File file = SD.open(EDIT_JOURNAL_FILE);
+  if (!file) return 0;
+  EditJournalEntry entries[16];
+  int edits = 0;
+  size_t len;
+  file.seek(sizeof(EditJournalEntry));  // Past the base
+  while ((len = file.read((uint8_t *)entries, sizeof(entries))) >= sizeof(EditJournalEntry)) {
+    for (size_t i = 0; i < len / sizeof(EditJournalEntry); i++) {
+      const EditJournalEntry &e = entries[i];
+      if (e.param >= journalParamCount) continue;
+      edits++;
+      *journalParams[e.param] = e.value;
+    }
+  }
+  file.close();
+
+  int changed = 0;
+  for (int i = 0; i < journalParamCount; i++) {
+    if (*journalParams[i] != journalBase[i]) changed++;
+  }
+  if (edits) {
+    Serial.println("Edit journal: " + String(edits) + " edits, " + String(changed) + " parameters restored on patch " + String(patchNo));
+  }
+  return changed;
+}
@@ -2,7 +2,11 @@
 
 #define EEPROM_MIDI_CH 0
 #define EEPROM_ENCODER_DIR 1
-#define EEPROM_LAST_PATCH 2
+#define EEPROM_LAST_PATCH 15  // Two bytes, high byte first
+#define EEPROM_PATCH_PAGE 17
+#define EEPROM_SKIP_DUPLICATES 18
+#define EEPROM_RECALL_SYSEX 19
+#define EEPROM_SYSEX_GAP 20
 #define EEPROM_MIDI_OUT_CH 3
 #define EEPROM_LOAD_FACTORY 4
 #define EEPROM_UPDATE_PARAMS 5
@@ -14,6 +18,7 @@
 #define EEPROM_ENCODER_ACCELERATE 11
 #define EEPROM_AFTERTOUCH 12
 #define EEPROM_SAVE_EDITOR_ALL 13
+#define EEPROM_BROWSE_BY_NAME 14
 
 int getMIDIChannel() {
   byte midiChannel = EEPROM.read(EEPROM_MIDI_CH);
@@ -64,14 +69,27 @@ void storeUpdateParams(byte updateParameters)
 }
 
 int getLastPatch() {
-  int lastPatchNumber = EEPROM.read(EEPROM_LAST_PATCH);
-  if (lastPatchNumber < 1 || lastPatchNumber > 999) lastPatchNumber = 1;
+  int lastPatchNumber = EEPROM.read(EEPROM_LAST_PATCH) << 8 | EEPROM.read(EEPROM_LAST_PATCH + 1);
+  if (lastPatchNumber < 1 || lastPatchNumber > PATCHES_LIMIT) lastPatchNumber = 1;
   return lastPatchNumber;
 }
 
 void storeLastPatch(int lastPatchNumber)
 {
-  EEPROM.write(EEPROM_LAST_PATCH, lastPatchNumber);
+  EEPROM.write(EEPROM_LAST_PATCH, lastPatchNumber >> 8);
+  EEPROM.write(EEPROM_LAST_PATCH + 1, lastPatchNumber & 0xFF);
+  EEPROM.commit();
+}
+
+int getPatchPage() {
+  byte page = EEPROM.read(EEPROM_PATCH_PAGE);
+  if (page >= PATCH_PAGES) page = 0;  //If EEPROM has no page stored
+  return page;
+}
+
+void storePatchPage(byte page)
+{
+  EEPROM.write(EEPROM_PATCH_PAGE, page);
   EEPROM.commit();
 }
 
@@ -168,3 +186,52 @@ void storeSaveAll(byte saupdate)
   EEPROM.write(EEPROM_SAVE_ALL, saupdate);
   EEPROM.commit();
 }
+
+boolean getBrowseByName() {
+  byte bn = EEPROM.read(EEPROM_BROWSE_BY_NAME);
+  if (bn < 0 || bn > 1)return false;
+  return bn ? true : false;
+}
+
+void storeBrowseByName(byte bnupdate)
+{
+  EEPROM.write(EEPROM_BROWSE_BY_NAME, bnupdate);
+  EEPROM.commit();
+}
+
+boolean getSkipDuplicates() {
+  byte sd = EEPROM.read(EEPROM_SKIP_DUPLICATES);
+  if (sd < 0 || sd > 1)return false;
+  return sd ? true : false;
+}
+
+void storeSkipDuplicates(byte sdupdate)
+{
+  EEPROM.write(EEPROM_SKIP_DUPLICATES, sdupdate);
+  EEPROM.commit();
+}
+
+boolean getRecallSysEx() {
+  byte rs = EEPROM.read(EEPROM_RECALL_SYSEX);
+  if (rs < 0 || rs > 1)return false;
+  return rs ? true : false;
+}
+
+void storeRecallSysEx(byte rsupdate)
+{
+  EEPROM.write(EEPROM_RECALL_SYSEX, rsupdate);
+  EEPROM.commit();
+}
+
+// Milliseconds between SysEx messages
+byte getSysExGap() {
+  byte gap = EEPROM.read(EEPROM_SYSEX_GAP);
+  if (gap > 50) return MIDI_SYSEX_GAP_US / 1000;
+  return gap;
+}
+
+void storeSysExGap(byte gapupdate)
+{
+  EEPROM.write(EEPROM_SYSEX_GAP, gapupdate);
+  EEPROM.commit();
+}
@@ -0,0 +1,639 @@
+// MIDI port
+// The MIDI library writes through MidiPort instead of straight to Serial2. Each message is
+// queued whole on one of four lanes and an esp_timer drains them at the wire rate, one byte
+// per MIDI_BYTE_US, so nothing in loop() waits on the UART or sleeps to pace the synth.
+//   MIDI_LANE_THRU   messages passed straight through from MIDI in, always sent first.
+//   MIDI_LANE_PLAY   notes, pitch bend, aftertouch and realtime sent by the editor. Realtime
+//                    bytes go out even in the middle of another message.
+//   MIDI_LANE_PARAM  control and program changes, one per MIDI_CC_GAP_US so the Tauntek
+//                    board keeps up, held for MIDI_PROGRAM_HOLD_US after a program change.
+//   MIDI_LANE_SYSEX  SysEx, midiSysExGapUs between messages (the "SysEx Gap" setting).
+// Apart from realtime, a message is never split by another one. Only a full lane makes the
+// sender wait, and a SysEx longer than its lane streams out while it is being written.
+// A CC for a controller that is still waiting in the param lane overwrites the waiting
+// value instead of queueing behind it, so a fast knob turn costs one message per gap. In the
+// same way a program change, or a SysEx sent between beginReplaceable() and endReplaceable(),
+// takes the place of the last one if nothing has been queued since and it hasn't started to
+// go out, so scrolling through patches only sends the one it stops on.
+//
+// MIDI in is filtered a byte at a time on the UART event task as it arrives. Realtime and
+// system common bytes are passed through at once, and each channel message goes to the
+// sketch's thru filter, which either sends it on (rewritten if need be), drops it, or leaves
+// it for the MIDI library. Only what the filter leaves, and SysEx, is held for MIDI.read(),
+// so thru never waits on loop(). The held bytes go into a ring of MIDI_IN_SIZE, stamped with
+// their arrival time, big enough to ride out a slow loop() pass without losing any. Bytes or
+// thru messages that still don't fit are counted, as are UART overflows, and reportMidiIn()
+// logs the counters along with the ring's high water mark and the longest a byte waited.
+#include <esp_timer.h>
+
+#define MIDI_BYTE_US 320  // 10 bits at 31250 baud
+#define MIDI_OUT_BURST 4  // Most bytes a late timer may catch up with at once
+#define MIDI_CC_GAP_US 3000
+#define MIDI_PROGRAM_HOLD_US 50000  // Let the synth load the program before its CCs
+#define MIDI_SYSEX_GAP_US 5000  // Default for midiSysExGapUs
+
+#define MIDI_STATS_INTERVAL 10000  // ms between CC merge reports on Serial
+#define MIDI_CC_NOT_PENDING 0xFFFF
+
+#define MIDI_LANE_THRU_SIZE 256  // Powers of two
+#define MIDI_LANE_PLAY_SIZE 256
+#define MIDI_LANE_PARAM_SIZE 512
+#define MIDI_LANE_SYSEX_SIZE 2048
+#define MIDI_IN_SIZE 4096  // Bytes held for the library, power of two, 1.3s of input
+#define MIDI_RX_BUFFER 1024  // UART driver buffer in front of the filter
+
+enum MidiLaneId : uint8_t {
+  MIDI_LANE_THRU,
+  MIDI_LANE_PLAY,
+  MIDI_LANE_PARAM,
+  MIDI_LANE_SYSEX,
+  MIDI_LANES
+};
+
+struct MidiLane
+{
+  byte *buf;
+  uint16_t mask;
+  uint16_t head;                // Next byte the sender writes, its own until committed
+  volatile uint16_t committed;  // End of the bytes the timer may send
+  volatile uint16_t tail;       // Next byte to send
+  bool sending;                 // A message is partly sent
+  byte status;                  // Of the message being sent
+  int8_t left;                  // Data bytes still to send, -1 until the end of a SysEx
+  int64_t readyAt;              // When the next message may start
+};
+
+byte midiLaneThru[MIDI_LANE_THRU_SIZE];
+byte midiLanePlay[MIDI_LANE_PLAY_SIZE];
+byte midiLaneParam[MIDI_LANE_PARAM_SIZE];
+byte midiLaneSysex[MIDI_LANE_SYSEX_SIZE];
+
+MidiLane midiLanes[MIDI_LANES] = {
+  { midiLaneThru, MIDI_LANE_THRU_SIZE - 1 },
+  { midiLanePlay, MIDI_LANE_PLAY_SIZE - 1 },
+  { midiLaneParam, MIDI_LANE_PARAM_SIZE - 1 },
+  { midiLaneSysex, MIDI_LANE_SYSEX_SIZE - 1 },
+};
+
+HardwareSerial *midiSerial = nullptr;
+esp_timer_handle_t midiOutTimer = nullptr;
+portMUX_TYPE midiOutMux = portMUX_INITIALIZER_UNLOCKED;
+bool midiOutRunning = false;  // Timer armed, guarded by midiOutMux
+int64_t midiOutLastTick = 0;
+
+// Written by the UART event task, read by loop()
+byte midiIn[MIDI_IN_SIZE];
+uint32_t midiInTime[MIDI_IN_SIZE];  // esp_timer_get_time() when each byte came in
+volatile uint16_t midiInHead = 0;
+volatile uint16_t midiInTail = 0;
+volatile uint32_t midiInBytes = 0;      // Off the UART since boot
+volatile uint16_t midiInHighWater = 0;  // Most bytes ever held
+volatile uint32_t midiInOverflows = 0;  // Bytes dropped with the ring full
+volatile uint32_t midiThruDropped = 0;  // Thru messages dropped with the lane full
+volatile uint32_t midiUartOverflows = 0;
+volatile unsigned long midiInLastAt = 0;  // millis() when the last byte other than realtime came in
+uint32_t midiInMaxWait = 0;             // Longest a byte was held, in us
+uint16_t midiInReported = 0;
+uint32_t midiInDropsReported = 0;
+unsigned long midiInStatsAt = 0;
+
+uint32_t midiSysExGapUs = MIDI_SYSEX_GAP_US;
+int64_t midiSysExEndAt = 0;   // When the last SysEx finished going out
+uint32_t midiSysExGaps = 0;   // Measured gaps between SysEx messages since the last reset
+int64_t midiSysExGapTotal = 0;
+
+uint32_t midiLaneBytes[MIDI_LANES];  // Bytes handed to each lane by the sketch since boot
+uint16_t midiCCPending[128];  // Param lane position of the last CC queued per controller
+uint32_t midiCCQueued = 0;    // CCs handed to the port
+uint32_t midiCCMerged = 0;    // Of those, merged into one already waiting
+uint32_t midiCCReported = 0;
+uint16_t midiProgramPending = MIDI_CC_NOT_PENDING;  // Param lane position of the last program change
+uint16_t midiReplaceFrom = MIDI_CC_NOT_PENDING;     // SysEx lane span of the last replaceable message
+uint16_t midiReplaceTo = 0;
+uint32_t midiReplaced = 0;  // Program changes and SysEx replaced before they went out
+uint32_t midiReplacedReported = 0;
+uint32_t midiOutDropped = 0;  // Messages that found their lane full before begin()
+unsigned long midiStatsAt = 0;
+
+// Data bytes after a status byte, -1 for SysEx
+int8_t midiDataBytes(byte status) {
+  switch (status & 0xF0) {
+    case 0xC0:
+    case 0xD0:
+      return 1;
+    case 0xF0:
+      if (status == 0xF0) return -1;
+      if (status == 0xF2) return 2;
+      return (status == 0xF1 || status == 0xF3) ? 1 : 0;
+  }
+  return 2;
+}
+
+// Gap the lane keeps after a message with this status
+uint32_t midiGapAfter(byte status) {
+  switch (status & 0xF0) {
+    case 0xB0: return MIDI_CC_GAP_US;
+    case 0xC0: return MIDI_PROGRAM_HOLD_US;
+  }
+  return status == 0xF0 ? midiSysExGapUs : 0;
+}
+
+bool midiLaneEmpty(const MidiLane &lane) {
+  return lane.tail == lane.committed;
+}
+
+// Lane the next byte comes from, -1 if nothing may go yet. Called under midiOutMux.
+int nextMidiLane(int64_t now) {
+  for (int i = MIDI_LANE_THRU; i <= MIDI_LANE_PLAY; i++) {
+    const MidiLane &lane = midiLanes[i];
+    if (!midiLaneEmpty(lane) && lane.buf[lane.tail] >= 0xF8) return i;
+  }
+  for (int i = 0; i < MIDI_LANES; i++) {
+    if (midiLanes[i].sending) return midiLaneEmpty(midiLanes[i]) ? -1 : i;
+  }
+  for (int i = 0; i < MIDI_LANES; i++) {
+    if (!midiLaneEmpty(midiLanes[i]) && now >= midiLanes[i].readyAt) return i;
+  }
+  return -1;
+}
+
+// Takes the next byte off a lane and keeps track of where its message ends
+byte takeMidiByte(MidiLane &lane, int64_t now) {
+  byte b = lane.buf[lane.tail];
+  lane.tail = (lane.tail + 1) & lane.mask;
+  if (b >= 0xF8) return b;
+
+  bool done;
+  if (!lane.sending) {
+    lane.status = b;
+    lane.left = midiDataBytes(b);
+    done = lane.left == 0;
+    if (b == 0xF0 && midiSysExEndAt) {
+      midiSysExGapTotal += now - midiSysExEndAt;
+      midiSysExGaps++;
+    }
+  } else if (lane.left < 0) {
+    done = b == 0xF7;
+  } else {
+    done = --lane.left == 0;
+  }
+  lane.sending = !done;
+  if (done && &lane != &midiLanes[MIDI_LANE_THRU]) lane.readyAt = now + midiGapAfter(lane.status);  // Thru is never held back
+  if (done && lane.status == 0xF0) midiSysExEndAt = now;
+  return b;
+}
+
+void midiOutTick(void *) {
+  int64_t now = esp_timer_get_time();
+  int budget = (now - midiOutLastTick) / MIDI_BYTE_US;
+  if (budget < 1) budget = 1;
+  if (budget > MIDI_OUT_BURST) budget = MIDI_OUT_BURST;
+  midiOutLastTick = now;
+
+  byte out[MIDI_OUT_BURST];
+  int n = 0;
+  bool pending = false;
+  portENTER_CRITICAL(&midiOutMux);
+  while (n < budget) {
+    int lane = nextMidiLane(now);
+    if (lane < 0) break;
+    out[n++] = takeMidiByte(midiLanes[lane], now);
+  }
+  for (int i = 0; i < MIDI_LANES; i++) {
+    pending |= !midiLaneEmpty(midiLanes[i]);
+  }
+  midiOutRunning = pending;
+  portEXIT_CRITICAL(&midiOutMux);
+
+  if (n) midiSerial->write(out, n);
+  if (pending) esp_timer_start_once(midiOutTimer, MIDI_BYTE_US);
+}
+
+void kickMidiOut() {
+  if (!midiOutTimer) return;  // Queued until begin()
+  bool start = false;
+  portENTER_CRITICAL(&midiOutMux);
+  if (!midiOutRunning) {
+    midiOutRunning = true;
+    start = true;
+  }
+  portEXIT_CRITICAL(&midiOutMux);
+  if (start) {
+    midiOutLastTick = esp_timer_get_time() - MIDI_BYTE_US;
+    esp_timer_start_once(midiOutTimer, 1);
+  }
+}
+
+// Bytes waiting on a lane, read from loop() while the timer drains it
+uint16_t midiLaneUsed(int id) {
+  const MidiLane &lane = midiLanes[id];
+  return (lane.head - lane.tail) & lane.mask;
+}
+
+void resetMidiSysExGaps() {
+  portENTER_CRITICAL(&midiOutMux);
+  midiSysExEndAt = 0;
+  midiSysExGaps = 0;
+  midiSysExGapTotal = 0;
+  portEXIT_CRITICAL(&midiOutMux);
+}
+
+// Average gap measured between SysEx messages on the wire, in us
+uint32_t midiSysExGapAverage() {
+  return midiSysExGaps ? midiSysExGapTotal / midiSysExGaps : 0;
+}
+
+#define MIDI_ALL_LANES ((1 << MIDI_LANES) - 1)  // Lane masks have bit 1 << MidiLaneId
+
+uint32_t midiOutQueued(uint8_t lanes = MIDI_ALL_LANES) {
+  uint32_t bytes = 0;
+  for (int i = 0; i < MIDI_LANES; i++) {
+    if (lanes & (1 << i)) bytes += midiLaneBytes[i];
+  }
+  return bytes;
+}
+
+// True once everything queued on the lanes has gone out
+bool midiOutIdle(uint8_t lanes = MIDI_ALL_LANES) {
+  for (int i = 0; i < MIDI_LANES; i++) {
+    if ((lanes & (1 << i)) && (!midiLaneEmpty(midiLanes[i]) || midiLanes[i].sending)) return false;
+  }
+  return true;
+}
+
+// Nothing going out and nothing but realtime come in for ms
+bool midiQuiet(unsigned long ms) {
+  return midiOutIdle() && millis() - midiInLastAt >= ms;
+}
+
+// Called when a program change is queued, a CC after it must not be merged into one before it
+void forgetPendingCCs() {
+  memset(midiCCPending, 0xFF, sizeof(midiCCPending));
+}
+
+// True while the message at pos hasn't started to go out. Called under midiOutMux.
+bool midiUnsent(const MidiLane &lane, uint16_t pos) {
+  return ((pos - lane.tail) & lane.mask) < ((lane.committed - lane.tail) & lane.mask);
+}
+
+// Latest value wins. The CC just written at the head of the param lane is dropped if one for
+// the same controller and channel is still waiting, after putting its value in that one.
+bool mergeMidiCC(MidiLane &lane) {
+  uint16_t pos = (lane.head - 3) & lane.mask;
+  byte status = lane.buf[pos];
+  byte cc = lane.buf[(pos + 1) & lane.mask] & 0x7F;
+  byte value = lane.buf[(pos + 2) & lane.mask];
+  uint16_t prev = midiCCPending[cc];
+  bool merged = false;
+  midiCCQueued++;
+
+  portENTER_CRITICAL(&midiOutMux);
+  // Only while its status byte hasn't gone out yet
+  if (prev != MIDI_CC_NOT_PENDING && midiUnsent(lane, prev)
+      && lane.buf[prev] == status && lane.buf[(prev + 1) & lane.mask] == cc) {
+    lane.buf[(prev + 2) & lane.mask] = value;
+    merged = true;
+  }
+  portEXIT_CRITICAL(&midiOutMux);
+
+  if (merged) {
+    lane.head = pos;
+    midiLaneBytes[MIDI_LANE_PARAM] -= 3;
+    midiCCMerged++;
+  } else {
+    midiCCPending[cc] = pos;
+  }
+  return merged;
+}
+
+// The program change just written at the head of the param lane replaces the one right before
+// it on the same channel if that hasn't gone out, so only one program and one hold are sent.
+bool mergeMidiProgram(MidiLane &lane) {
+  uint16_t pos = (lane.head - 2) & lane.mask;
+  uint16_t prev = midiProgramPending;
+  bool merged = false;
+
+  portENTER_CRITICAL(&midiOutMux);
+  if (prev != MIDI_CC_NOT_PENDING && ((prev + 2) & lane.mask) == pos && midiUnsent(lane, prev)
+      && lane.buf[prev] == lane.buf[pos]) {
+    lane.buf[(prev + 1) & lane.mask] = lane.buf[(pos + 1) & lane.mask];
+    merged = true;
+  }
+  portEXIT_CRITICAL(&midiOutMux);
+
+  if (merged) {
+    lane.head = pos;
+    midiLaneBytes[MIDI_LANE_PARAM] -= 2;
+    midiReplaced++;
+  } else {
+    midiProgramPending = pos;
+  }
+  return merged;
+}
+
+// Logs the CC merge counters now and then, called from loop()
+void reportMidiOut() {
+  if ((midiCCMerged == midiCCReported && midiReplaced == midiReplacedReported) || millis() - midiStatsAt < MIDI_STATS_INTERVAL) return;
+  midiStatsAt = millis();
+  midiCCReported = midiCCMerged;
+  midiReplacedReported = midiReplaced;
+  uint32_t savedUs = midiCCMerged * (3 * MIDI_BYTE_US + MIDI_CC_GAP_US);
+  Serial.println("MIDI out: " + String(midiCCQueued) + " CCs, " + String(midiCCMerged) + " merged, "
+                 + String(savedUs / 1000) + "ms of wire time saved, " + String(midiReplaced) + " recalls replaced");
+}
+
+// Logs the input counters now and then if the high water mark rose or anything was lost,
+// called from loop()
+void reportMidiIn() {
+  uint32_t drops = midiInOverflows + midiThruDropped + midiUartOverflows;
+  if ((midiInHighWater == midiInReported && drops == midiInDropsReported) || millis() - midiInStatsAt < MIDI_STATS_INTERVAL) return;
+  midiInStatsAt = millis();
+  midiInReported = midiInHighWater;
+  midiInDropsReported = drops;
+  Serial.println("MIDI in: " + String(midiInBytes) + " bytes, high water " + String(midiInHighWater) + "/" + String(MIDI_IN_SIZE)
+                 + ", longest wait " + String(midiInMaxWait / 1000) + "ms, dropped " + String(midiInOverflows) + " bytes held, "
+                 + String(midiThruDropped) + " thru, " + String(midiUartOverflows) + " UART overflows");
+}
+
+typedef void (*MidiSysExByteHandler)(byte b);
+
+enum MidiThruAction : uint8_t {
+  MIDI_THRU_SEND,   // Send on as it is now
+  MIDI_THRU_PARSE,  // Leave for MIDI.read()
+  MIDI_THRU_DROP
+};
+
+// Decides what happens to a channel message coming in, may rewrite msg and len (up to 3 bytes).
+// Runs on the UART event task, so it must only look at settings.
+typedef MidiThruAction (*MidiThruFilter)(byte *msg, byte &len);
+
+// Transport for midi::MidiInterface, Serial2 must already be running
+class MidiPort
+{
+public:
+  static const bool thruActivated = false;
+
+  MidiPort(HardwareSerial &serial)
+    : serial(serial) {
+    forgetPendingCCs();
+  }
+
+  void begin() {
+    midiSerial = &serial;
+    esp_timer_create_args_t args = {};
+    args.callback = midiOutTick;
+    args.name = "midi out";
+    esp_timer_create(&args, &midiOutTimer);
+    if (!midiOutIdle()) kickMidiOut();
+    if (midiOutDropped) Serial.println("MIDI out: " + String(midiOutDropped) + " messages sent before begin() dropped");
+    serial.setRxFIFOFull(1);  // Called back for every byte, not every 120
+    serial.onReceive([this]() {
+      receive();
+    });
+    serial.onReceiveError([](hardwareSerial_error_t error) {
+      if (error == UART_FIFO_OVF_ERROR || error == UART_BUFFER_FULL_ERROR) midiUartOverflows++;
+    });
+  }
+
+  // While on, CCs queue on the SysEx lane behind the SysEx sent before them, for parameters a
+  // SysEx message overwrites and a CC has to put right. They are not merged.
+  void sendCCsAfterSysEx(bool on) {
+    ccAfterSysEx = on;
+  }
+
+  // Around a SysEx that a later one makes pointless, such as a patch recall. If the SysEx lane
+  // still ends with the last such message and none of it has gone out, it is taken back.
+  void beginReplaceable() {
+    MidiLane &sysex = midiLanes[MIDI_LANE_SYSEX];
+    if (midiReplaceFrom != MIDI_CC_NOT_PENDING && midiReplaceTo == sysex.head) {
+      portENTER_CRITICAL(&midiOutMux);
+      bool unsent = midiUnsent(sysex, midiReplaceFrom);
+      if (unsent) sysex.committed = midiReplaceFrom;
+      portEXIT_CRITICAL(&midiOutMux);
+      if (unsent) {
+        midiLaneBytes[MIDI_LANE_SYSEX] -= (sysex.head - midiReplaceFrom) & sysex.mask;
+        sysex.head = midiReplaceFrom;
+        midiReplaced++;
+      }
+    }
+    midiReplaceFrom = sysex.head;
+  }
+
+  void endReplaceable() {
+    midiReplaceTo = midiLanes[MIDI_LANE_SYSEX].head;
+  }
+
+  // Without a filter every channel message is left for the library
+  void setThruFilter(MidiThruFilter filter) {
+    thruFilter = filter;
+  }
+
+  bool beginTransmission(midi::MidiType type) {
+    this->type = type;
+    switch (type) {
+      case midi::ControlChange:
+        lane = &midiLanes[ccAfterSysEx ? MIDI_LANE_SYSEX : MIDI_LANE_PARAM];
+        break;
+      case midi::ProgramChange:
+        lane = &midiLanes[MIDI_LANE_PARAM];
+        break;
+      case midi::SystemExclusiveStart:
+        lane = &midiLanes[MIDI_LANE_SYSEX];
+        break;
+      default:
+        lane = &midiLanes[MIDI_LANE_PLAY];
+        break;
+    }
+    start = lane->head;
+    dropping = false;
+    return true;
+  }
+
+  void write(byte value) {
+    if (dropping) return;
+    uint16_t next = (lane->head + 1) & lane->mask;
+    if (next == lane->tail) {
+      if (!midiOutTimer) {  // Nothing drains the lane before begin(), the message is dropped whole
+        dropping = true;
+        return;
+      }
+      lane->committed = lane->head;  // Let what's written so far stream out
+      kickMidiOut();
+      while (next == lane->tail) vTaskDelay(1);
+    }
+    lane->buf[lane->head] = value;
+    lane->head = next;
+    midiLaneBytes[lane - midiLanes]++;
+  }
+
+  void endTransmission() {
+    if (dropping) {
+      midiLaneBytes[lane - midiLanes] -= (lane->head - start) & lane->mask;
+      lane->head = start;
+      midiOutDropped++;
+      return;
+    }
+    if (type == midi::ProgramChange) {
+      if (mergeMidiProgram(*lane)) return;
+      forgetPendingCCs();
+    } else if (type == midi::ControlChange && lane == &midiLanes[MIDI_LANE_PARAM] && mergeMidiCC(*lane)) {
+      return;
+    }
+    lane->committed = lane->head;
+    kickMidiOut();
+  }
+
+  byte read() {
+    byte b = midiIn[midiInTail];
+    uint32_t wait = (uint32_t)esp_timer_get_time() - midiInTime[midiInTail];
+    if (wait > midiInMaxWait) midiInMaxWait = wait;
+    midiInTail = (midiInTail + 1) & (MIDI_IN_SIZE - 1);
+    return b;
+  }
+
+  // SysEx bytes go to handler as they arrive instead of being buffered by the library
+  void setHandleSysExByte(MidiSysExByteHandler handler) {
+    sysexHandler = handler;
+  }
+
+  // receive() always ends a SysEx with F7 before the next message
+  unsigned available() {
+    while (sysexHandler && midiInTail != midiInHead) {
+      byte b = midiIn[midiInTail];
+      if (b == 0xF0) {
+        inSysEx = true;
+      } else if (!inSysEx) {
+        break;
+      } else if (b == 0xF7) {
+        inSysEx = false;
+      }
+      sysexHandler(read());
+    }
+    return (midiInHead - midiInTail) & (MIDI_IN_SIZE - 1);
+  }
+
+private:
+  // Runs on the UART event task whenever bytes arrive
+  void receive() {
+    while (serial.available()) {
+      byte b = serial.read();
+      midiInBytes++;
+      if (b < 0xF8) midiInLastAt = millis();  // Clock and active sensing run all the time
+      if (b >= 0xF8) {
+        sendThru(&b, 1);  // Realtime, even in the middle of another message
+      } else if (b & 0x80) {
+        if (inStatus == 0xF0) holdIn(0xF7);  // Any status byte ends a SysEx
+        inStatus = b;
+        inMsg[0] = b;
+        inLen = 1;
+        inNeed = midiDataBytes(b);
+        if (b == 0xF0) {
+          holdIn(b);
+        } else if (b == 0xF7 || b == 0xF4 || b == 0xF5) {
+          inStatus = 0;  // Stray end of SysEx or undefined
+        } else if (inNeed == 0) {
+          receiveMessage();  // Tune request
+        }
+      } else if (inStatus == 0xF0) {
+        holdIn(b);
+      } else if (inStatus) {
+        inMsg[inLen++] = b;
+        if (inLen > inNeed) receiveMessage();
+      }
+    }
+  }
+
+  void receiveMessage() {
+    byte msg[3];
+    byte len = inLen;
+    memcpy(msg, inMsg, len);
+    inLen = 1;  // Running status keeps inMsg[0]
+    if (inStatus >= 0xF0) {
+      inStatus = 0;  // System common cancels running status and is always passed through
+      sendThru(msg, len);
+      return;
+    }
+    switch (thruFilter ? thruFilter(msg, len) : MIDI_THRU_PARSE) {
+      case MIDI_THRU_SEND:
+        sendThru(msg, len);
+        break;
+      case MIDI_THRU_PARSE:
+        for (byte i = 0; i < len; i++) holdIn(msg[i]);
+        break;
+      case MIDI_THRU_DROP:
+        break;
+    }
+  }
+
+  // The thru lane has no other writer, a message that doesn't fit is dropped
+  void sendThru(const byte *msg, byte len) {
+    MidiLane &thru = midiLanes[MIDI_LANE_THRU];
+    if (((thru.tail - thru.head - 1) & thru.mask) < len) {
+      midiThruDropped++;
+      return;
+    }
+    for (byte i = 0; i < len; i++) {
+      thru.buf[thru.head] = msg[i];
+      thru.head = (thru.head + 1) & thru.mask;
+    }
+    thru.committed = thru.head;
+    kickMidiOut();
+  }
+
+  void holdIn(byte b) {
+    uint16_t next = (midiInHead + 1) & (MIDI_IN_SIZE - 1);
+    if (next == midiInTail) {
+      midiInOverflows++;
+      return;
+    }
+    midiIn[midiInHead] = b;
+    midiInTime[midiInHead] = esp_timer_get_time();
+    midiInHead = next;
+    uint16_t held = (next - midiInTail) & (MIDI_IN_SIZE - 1);
+    if (held > midiInHighWater) midiInHighWater = held;
+  }
+
+  HardwareSerial &serial;
+  MidiLane *lane = nullptr;
+  uint16_t start = 0;     // Lane head when the message began
+  bool dropping = false;  // The message didn't fit
+  bool ccAfterSysEx = false;
+  midi::MidiType type = midi::InvalidType;
+  MidiSysExByteHandler sysexHandler = nullptr;
+  bool inSysEx = false;
+  MidiThruFilter thruFilter = nullptr;
+  byte inStatus = 0;  // Of the message coming in, 0 for none
+  byte inMsg[3];
+  byte inLen = 0;
+  int8_t inNeed = 0;
+};
+
+// A SysEx message written as a stream straight onto the SysEx lane, between begin() and end().
+// Nothing else may be sent through the port in between.
+class MidiSysExStream : public Print
+{
+public:
+  MidiSysExStream(MidiPort &port)
+    : port(port) {}
+
+  void begin() {
+    port.beginTransmission(midi::SystemExclusiveStart);
+  }
+
+  size_t write(uint8_t b) override {
+    port.write(b);
+    return 1;
+  }
+
+  size_t write(const uint8_t *buf, size_t len) override {
+    for (size_t i = 0; i < len; i++) port.write(buf[i]);
+    return len;
+  }
+
+  void end() {
+    port.endTransmission();
+  }
+
+private:
+  MidiPort &port;
+};
@@ -12,30 +12,9 @@ const unsigned long displayTimeout = 5000;  // e.g. 5 seconds
 
 char buffer[10];
 
-// Buffer for raw incoming SysEx (nibbles included)
-byte sysexBuffer[HEADER_BYTES + (NUM_PATCHES * PATCH_NIBBLES) + 1];  
-unsigned sysexIndex = 0;
-
-// Final decoded patches (12 bytes each)
-byte receivedPatches[NUM_PATCHES][PATCH_BYTES];
 bool sendingSysEx = false;
-bool receivingSysEx = false;
-bool sysexComplete = false;
-byte dumpType = 0;
-int headerSkip = 0;
-const int totalBytes = 1920;
+bool receivingSysEx = false;  // A SysEx message is coming in
 int bankPatchCounter = 0;   // how many patches received in current bank
-byte data(24);
-byte sysexData[24];
-#define SYSEX_BUFFER_SIZE 2048   // enough for 1926 bytes
-#define HEADER_SIZE       5
-#define PATCH_BLOCK_SIZE  24   // nibbles per patch
-#define NUM_PATCHES       80
-
-uint8_t ramArray[NUM_PATCHES][PATCH_BLOCK_SIZE];
-
-int currentBlock = 0;
-int byteIndex = 0;
 
 int MIDIThru = midi::Thru::Off;  //(EEPROM)
 String patchName = INITPATCHNAME;
@@ -51,9 +30,30 @@ boolean saveCurrent = false;
 boolean afterTouch = false;
 boolean saveAll = false;
 boolean saveEditorAll = false;
+#define SYX_TRANSFER_PATCH 1
+#define SYX_TRANSFER_BANK 2
+#define SYX_TRANSFER_LIBRARY 3
+byte syxImport = 0;  // Settings request, 0 = none
+byte syxExport = 0;
+#define LAST_PATCH_STORE_DELAY 5000
+int storedLastPatch = 0;  // Patch number in EEPROM
+int patchPageRequest = -1;  // Library page chosen in settings, loaded from loop()
+boolean synthResyncRequest = false;  // Settings request to resend every parameter
+// Last value sent on each CC, so a recall only sends the parameters that differ from what
+// the synth already has. CC_UNSENT until sent, and forgotten whenever the synth may have
+// changed behind our back: a program change, a SysEx dump or a change of output channel.
+#define CC_UNSENT 0xFF
+byte ccMirror[128];
+boolean ccMirrorValid = false;
 byte accelerate = 1;
 int speed = 1;
 boolean updateParams = false;  //(EEPROM)
+boolean recallSysEx = false;   // Recall sends one 0x02 SysEx instead of a CC per parameter (EEPROM)
+boolean ccMirrorOnly = false;  // midiCCOut() only records the value, the synth has it already
+#define RECALL_LANES ((1 << MIDI_LANE_PARAM) | (1 << MIDI_LANE_SYSEX))  // What a recall queues on, thru and notes don't hold it up
+int recallTimedPatch = 0;         // DEBUG_CHECKS builds time each recall to sound
+unsigned long recallTimedAt = 0;  // micros() when a recall was handed to the MIDI port, 0 = none
+int recallTimedBytes = 0;
 int bankselect = 0;
 
 int osc1_octave = 0;
@@ -17,8 +17,7 @@
   Press Save again to save it. If you want to name/rename the patch, press the encoder enter button and use the encoder and enter button to choose an alphanumeric name.
   Holding Save for 1.5s will go into a patch deletion mode. Use encoder and enter button to choose and delete patch. Patch numbers will be changed on the SD card to be consecutive again.
 */
-//Agileware CircularBuffer available in libraries manager
-#include <CircularBuffer.hpp>
+#include <esp_partition.h>
 
 #define TOTALCHARS 63
 
@@ -27,172 +26,1375 @@ int charIndex = 0;
 char currentCharacter = 0;
 String renamedPatch = "";
 
-struct PatchNoAndName
+// Library directory
+// Everything the library keeps on the card lives under /lib, away from the root, so opening
+// it costs the same however many other files are on the card. FAT looks names up with a
+// linear scan of the directory. Legacy CSV patch files are moved out of the root into
+// buckets of PATCH_CSV_SHARD by patch number (/lib/csv/00 ... /lib/csv/09) when imported.
+#define PATCH_LIB_DIR "/lib"
+#define PATCH_CSV_DIR PATCH_LIB_DIR "/csv"
+#define PATCH_CSV_SHARD 100
+
+// Library pages
+// The library is split into pages of PATCHES_LIMIT patches. Each page is a complete bank,
+// manifest and slot map in its own directory, page 0 in /lib itself and page n in /lib/pNN.
+// Only the page being browsed is in RAM, so recall, browse and save cost the same whatever
+// the size of the whole library; moving to another page loads it from the card.
+#define PATCH_PAGES 32
+
+int patchPage = 0;
+char patchPageDir[16] = PATCH_LIB_DIR;
+
+void setPatchPageDir(int page) {
+  if (page) {
+    snprintf(patchPageDir, sizeof(patchPageDir), PATCH_LIB_DIR "/p%02d", page);
+  } else {
+    strcpy(patchPageDir, PATCH_LIB_DIR);
+  }
+}
+
+// Path of one of the library files of the current page
+String patchPagePath(const char *file) {
+  return String(patchPageDir) + "/" + file;
+}
+
+// Patch bank file
+// All PATCHES_LIMIT slots live in one preallocated file of fixed size records, so
+// recalling a patch is a single seek and a 32 byte read instead of opening a file per patch.
+// Record 0 is the file header. Which record holds patch n is looked up in the slot map below.
+#define PATCH_BANK_FILE "P61BANK.BIN"
+#define PATCH_BANK_MAGIC 0x42313650  // "P61B"
+#define PATCH_BANK_VERSION 1
+#define PATCH_NAME_LEN 13
+#define PATCH_RECORD_SIZE 32
+
+#define PATCH_FLAG_USED 0x01
+
+// Bits the Poly-61 12 byte format has no room for
+#define PATCH_EXT_KEY_ROTATE 0x01
+#define PATCH_EXT_OSC2_WAVE_HI 0x02  // osc2 waves 4-7 (Tauntek "New" waves)
+
+struct PatchRecord
 {
-  int patchNo;
-  String patchName;
+  uint8_t flags;
+  uint8_t ext;
+  uint8_t packed[PATCH_BYTES];  // As produced by encodePatch()
+  char name[PATCH_NAME_LEN + 1];
+  uint8_t reserved[2];
+  uint16_t crc;
 };
 
-CircularBuffer<PatchNoAndName, PATCHES_LIMIT> patches;
+static_assert(sizeof(PatchRecord) == PATCH_RECORD_SIZE, "PatchRecord must stay 32 bytes");
 
-size_t readField(fs::File *file, char *str, size_t size, const char *delim)
+struct PatchBankHeader
 {
-  uint8_t ch;
-  size_t n = 0;
-  while ((n + 1) < size && file->read(&ch, 1) == 1)
-  {
-    // Delete CR
-    if (ch == '\r') continue;
+  uint32_t magic;
+  uint16_t version;
+  uint16_t slots;
+  uint8_t reserved[PATCH_RECORD_SIZE - 8];
+};
+
+static_assert(sizeof(PatchBankHeader) == PATCH_RECORD_SIZE, "PatchBankHeader must be one record");
+
+File patchBank;
+
+// Library manifest
+// Name of every record, same layout as the bank (entry 0 is the header). Kept in step with
+// every record write, so boot can trust the bank without CRC checking all PATCHES_LIMIT
+// records. Only a missing manifest, or one whose checksum doesn't add up, forces a full
+// rescan of the bank.
+#define PATCH_MANIFEST_FILE "P61BANK.IDX"
+#define PATCH_MANIFEST_MAGIC 0x49313650  // "P61I"
+
+struct PatchManifestEntry
+{
+  uint16_t recordNo;  // 0 = empty record
+  char name[PATCH_NAME_LEN + 1];
+};
+
+struct PatchManifestHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t slots;
+  uint32_t checksum;  // Sum of the CRCs of all entries, so it can be updated one entry at a time
+  uint8_t reserved[4];
+};
+
+static_assert(sizeof(PatchManifestEntry) == sizeof(PatchManifestHeader), "Manifest header must be one entry");
+
+File patchManifest;
+uint32_t manifestChecksum = 0;
+
+// Slot map
+// Patch number to bank record. Deleting, inserting or moving patches only shuffles this
+// table and writes it back in one go; the records themselves never move on the card.
+#define PATCH_MAP_FILE "P61BANK.MAP"
+#define PATCH_MAP_MAGIC 0x4D313650  // "P61M"
+
+struct PatchMapHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t slots;
+  uint16_t crc;
+  uint8_t reserved[6];
+};
+
+File patchMapFile;
+uint16_t slotMap[PATCHES_LIMIT + 1];             // Record for each patch number, 0 = empty slot
+uint8_t recordMapped[(PATCHES_LIMIT + 8) / 8];  // Records referenced by slotMap
+
+// Storage task
+// Once setup() has loaded the library every card write is done by a FreeRTOS task, so loop()
+// keeps reading MIDI, polling the encoders and drawing while the card is busy. loop() changes
+// the RAM copies under storageMutex and queues what has to be written; the task copies it back
+// out under the same mutex and writes it. Reads and the patch list never touch the card, they
+// are served from the RAM library. Completion callbacks are queued back and run in loop() from
+// serviceStorage(). Before the task is started (boot, migration) requests run inline.
+#define STORAGE_QUEUE_LEN 16
+#define STORAGE_TASK_STACK 4096
+#define STORAGE_TASK_PRIORITY 1
+#define STORAGE_TASK_CORE 0  // loop() runs on core 1
+
+typedef void (*StorageCallback)();
+
+enum StorageOp : uint8_t {
+  STORAGE_WRITE_RECORD,  // One record and its manifest entry
+  STORAGE_WRITE_MAP,     // The slot map, after a delete, insert or move
+  STORAGE_FLUSH_BATCH,   // Every dirty record, the manifest header and the slot map if dirty
+  STORAGE_SYNC_FLASH,    // Changed sectors of the flash copy
+  STORAGE_WRITE_JOURNAL, // Buffered panel edits, see EditJournal.h
+  STORAGE_BARRIER        // Nothing, done once everything queued before it is
+};
+
+struct StorageRequest
+{
+  uint8_t op;
+  uint16_t recordNo;
+  StorageCallback onComplete;
+};
+
+struct StorageResponse
+{
+  uint8_t op;
+  bool ok;
+  StorageCallback onComplete;
+};
+
+TaskHandle_t storageTask = nullptr;
+QueueHandle_t storageRequests = nullptr;
+QueueHandle_t storageResponses = nullptr;
+SemaphoreHandle_t storageMutex = nullptr;
+volatile bool storageBarrierDone = false;
+
+// Guards patchLibrary, slotMap, manifestChecksum and the dirty flags against the task
+void lockStorage() {
+  if (storageMutex) xSemaphoreTake(storageMutex, portMAX_DELAY);
+}
+
+void unlockStorage() {
+  if (storageMutex) xSemaphoreGive(storageMutex);
+}
+
+// Write-back batches
+// Bulk imports (sysex banks, factory load) only update the RAM copies while a batch is open.
+// Closing the batch writes the dirty records out in record order, each contiguous run as one
+// write, followed by the manifest and the slot map once, then calls the completion callback.
+#define PATCH_BATCH_IDLE_FLUSH 2000  // Close a batch nobody finished (e.g. an aborted dump) after this many ms
+
+bool patchBatchOpen = false;
+bool slotMapDirty = false;
+uint8_t recordDirty[(PATCHES_LIMIT + 8) / 8];
+unsigned long patchBatchLastWrite = 0;
+StorageCallback patchBatchComplete = nullptr;
+
+// RAM copy of the whole bank laid out exactly like the file, so patch n is patchLibrary[n]
+// and slot 0 holds the header. Recall and browsing only ever read from here, writes go
+// through to the card.
+PatchRecord patchLibrary[PATCHES_LIMIT + 1];
+
+struct PatchCsvRecord;
+
+// Implemented in the sketch, converts a legacy CSV patch file to a record
+void patchRecordFromCsv(const PatchCsvRecord &csv, PatchRecord &rec);
+
+// CRC-16/CCITT
+uint16_t crc16(const uint8_t *p, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)p[i] << 8;
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+uint16_t patchRecordCrc(const PatchRecord &rec) {
+  // Everything but the crc field
+  return crc16((const uint8_t *)&rec, offsetof(PatchRecord, crc));
+}
+
+bool isValidPatchRecord(const PatchRecord &rec) {
+  return (rec.flags & PATCH_FLAG_USED) && rec.crc == patchRecordCrc(rec);
+}
+
+void getManifestEntry(int recordNo, PatchManifestEntry &entry) {
+  memset(&entry, 0, sizeof(entry));
+  if (patchLibrary[recordNo].flags & PATCH_FLAG_USED) {
+    entry.recordNo = recordNo;
+    strncpy(entry.name, patchLibrary[recordNo].name, PATCH_NAME_LEN);
+  }
+}
+
+uint16_t manifestEntryCrc(const PatchManifestEntry &entry) {
+  return crc16((const uint8_t *)&entry, sizeof(entry));
+}
+
+bool writeManifestHeader() {
+  lockStorage();
+  uint32_t checksum = manifestChecksum;
+  unlockStorage();
+  PatchManifestHeader header = {};
+  header.magic = PATCH_MANIFEST_MAGIC;
+  header.version = PATCH_BANK_VERSION;
+  header.slots = PATCHES_LIMIT;
+  header.checksum = checksum;
+  return patchManifest.seek(0) && patchManifest.write((const uint8_t *)&header, sizeof(header)) == sizeof(header);
+}
+
+// Rewrites the manifest from patchLibrary
+bool writePatchManifest() {
+  if (patchManifest) patchManifest.close();
+  patchManifest = SD.open(patchPagePath(PATCH_MANIFEST_FILE), FILE_WRITE);
+  if (!patchManifest) return false;
+
+  manifestChecksum = 0;
+  bool ok = writeManifestHeader();
+  for (int i = 1; i <= PATCHES_LIMIT && ok; i++) {
+    PatchManifestEntry entry;
+    getManifestEntry(i, entry);
+    manifestChecksum += manifestEntryCrc(entry);
+    ok = patchManifest.write((const uint8_t *)&entry, sizeof(entry)) == sizeof(entry);
+  }
+  ok = ok && writeManifestHeader();
+  patchManifest.close();
+
+  // Reopen for in place updates
+  patchManifest = SD.open(patchPagePath(PATCH_MANIFEST_FILE), "r+");
+  if (!ok) Serial.println("Error writing patch manifest");
+  return ok && patchManifest;
+}
+
+// Called before patchLibrary[recordNo] changes, with the record it's about to become. Only
+// keeps the checksum in step, the entry itself goes out with the record.
+void updateManifestEntry(int recordNo, const PatchRecord &rec) {
+  if (!patchManifest) return;
+
+  PatchManifestEntry oldEntry, newEntry;
+  getManifestEntry(recordNo, oldEntry);
+  memset(&newEntry, 0, sizeof(newEntry));
+  if (rec.flags & PATCH_FLAG_USED) {
+    newEntry.recordNo = recordNo;
+    strncpy(newEntry.name, rec.name, PATCH_NAME_LEN);
+  }
+  if (memcmp(&oldEntry, &newEntry, sizeof(newEntry)) == 0) return;
 
-    str[n++] = (char)ch;
-    if (strchr(delim, ch)) break;
+  manifestChecksum += manifestEntryCrc(newEntry) - manifestEntryCrc(oldEntry);
+}
+
+bool getBit(const uint8_t *bits, int n) {
+  return bits[n / 8] & (1 << (n % 8));
+}
+
+void setBit(uint8_t *bits, int n, bool value) {
+  if (value) {
+    bits[n / 8] |= 1 << (n % 8);
+  } else {
+    bits[n / 8] &= ~(1 << (n % 8));
   }
-  str[n] = '\0';
-  return n;
 }
 
-void recallPatchData(File& patchFile, String data[]) {
-  size_t n;
-  char str[64];  // Increase if any param string could be >20 chars
-  int i = 0;
+bool isRecordMapped(int recordNo) {
+  return getBit(recordMapped, recordNo);
+}
+
+void setRecordMapped(int recordNo, bool mapped) {
+  setBit(recordMapped, recordNo, mapped);
+}
+
+// Sound index
+// Every stored record is hashed (FNV-1a over the 12 packed bytes, the name doesn't count) into
+// chained buckets, so an import can ask whether a sound is already in the library without
+// scanning it. Records are linked by number, which stays put when patches are renumbered.
+// recordPatch maps a record back to its patch number. A new patch fills in its own entry;
+// deleting, inserting or moving patches renumbers them, so the map is rebuilt the next time
+// it is needed. Only loop() touches the index.
+#define PATCH_SOUND_BUCKETS 1024  // Power of two
+
+uint16_t soundBucket[PATCH_SOUND_BUCKETS];  // First record in each bucket, 0 = empty
+uint16_t soundNext[PATCHES_LIMIT + 1];      // Next record in the same bucket
+uint32_t soundHash[PATCHES_LIMIT + 1];
+uint8_t soundIndexed[(PATCHES_LIMIT + 8) / 8];
+uint16_t recordPatch[PATCHES_LIMIT + 1];  // Patch number of each mapped record, 0 for none
+bool recordPatchStale = true;
 
-  while (patchFile.available() && i < NO_OF_PARAMS) {
-    n = readField(&patchFile, str, sizeof(str), ",\n");
+bool importSkipDuplicates = false;  // Imports leave out sounds that are already stored
+int importDuplicates = 0;           // Duplicates met by the current import
 
-    if (n == 0) break;  // EOF or error
+uint32_t patchSoundHash(const uint8_t *packed) {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < PATCH_BYTES; i++) {
+    hash = (hash ^ packed[i]) * 16777619u;
+  }
+  return hash;
+}
+
+void indexSound(int recordNo) {
+  if (getBit(soundIndexed, recordNo)) return;
+  uint32_t hash = patchSoundHash(patchLibrary[recordNo].packed);
+  uint16_t &head = soundBucket[hash & (PATCH_SOUND_BUCKETS - 1)];
+  soundHash[recordNo] = hash;
+  soundNext[recordNo] = head;
+  head = recordNo;
+  setBit(soundIndexed, recordNo, true);
+}
+
+void unindexSound(int recordNo) {
+  if (!getBit(soundIndexed, recordNo)) return;
+  uint16_t *link = &soundBucket[soundHash[recordNo] & (PATCH_SOUND_BUCKETS - 1)];
+  while (*link && *link != recordNo) link = &soundNext[*link];
+  if (*link) *link = soundNext[recordNo];
+  setBit(soundIndexed, recordNo, false);
+}
+
+void rebuildSoundIndex() {
+  memset(soundBucket, 0, sizeof(soundBucket));
+  memset(soundIndexed, 0, sizeof(soundIndexed));
+  for (int i = 1; i <= PATCHES_LIMIT; i++) {
+    if (slotMap[i]) indexSound(slotMap[i]);
+  }
+}
 
-    if (str[n - 1] == ',' || str[n - 1] == '\n') {
-      str[n - 1] = '\0';  // Trim delimiter
+void rebuildRecordPatches() {
+  memset(recordPatch, 0, sizeof(recordPatch));
+  for (int i = 1; i <= PATCHES_LIMIT; i++) {
+    if (slotMap[i]) recordPatch[slotMap[i]] = i;
+  }
+  recordPatchStale = false;
+}
+
+// Lowest patch number other than patchNo holding the same packed bytes, 0 if none. patchNo's
+// own record doesn't count, it is about to be overwritten.
+int findSoundPatch(const uint8_t *packed, int patchNo) {
+  if (recordPatchStale) rebuildRecordPatches();
+  uint32_t hash = patchSoundHash(packed);
+  int found = 0;
+  for (int r = soundBucket[hash & (PATCH_SOUND_BUCKETS - 1)]; r; r = soundNext[r]) {
+    int stored = recordPatch[r];
+    if (!stored || stored == patchNo || soundHash[r] != hash || memcmp(patchLibrary[r].packed, packed, PATCH_BYTES)) continue;
+    if (!found || stored < found) found = stored;
+  }
+  return found;
+}
+
+// Called by imports for each incoming patch before it is written as patchNo. Reports it and
+// counts it in importDuplicates if the sound is stored already, and says whether to leave it out.
+bool skipDuplicateSound(const uint8_t *packed, int patchNo) {
+  int stored = findSoundPatch(packed, patchNo);
+  if (!stored) return false;
+  importDuplicates++;
+  Serial.println("Patch " + String(patchNo) + " duplicates patch " + String(stored) + (importSkipDuplicates ? ", skipped" : ""));
+  return importSkipDuplicates;
+}
+
+void reportImportDuplicates() {
+  if (importDuplicates) {
+    Serial.println(String(importDuplicates) + " duplicate sounds " + (importSkipDuplicates ? "skipped" : "imported"));
+  }
+}
+
+void rebuildRecordMapped() {
+  memset(recordMapped, 0, sizeof(recordMapped));
+  for (int i = 1; i <= PATCHES_LIMIT; i++) {
+    if (slotMap[i]) setRecordMapped(slotMap[i], true);
+  }
+  rebuildSoundIndex();
+  recordPatchStale = true;
+}
+
+// Flash tier
+// A hot copy of the library in the "patches" data partition (see partitions.csv), read in
+// place through the flash memory map. The SD card stays the cold store and backup; without a
+// card the library is loaded from here and the editor boots and plays as normal. Sector 0
+// holds a map header and the slot map, the records follow in bank order. Changed sectors are
+// rewritten by the storage task once edits have stopped for PATCH_FLASH_IDLE_SYNC, so a run
+// of saves costs one erase per sector rather than one per save.
+// Erasing a sector stops the flash cache on both cores for tens of ms, which holds off MIDI
+// thru, the input ring and the output timer along with everything else. So sectors are
+// rewritten one per storage request, only while MIDI has been quiet for
+// PATCH_FLASH_MIDI_QUIET, and each stall is measured and logged. Playing can put a sync off
+// for PATCH_FLASH_MAX_DEFER at most, after that it goes ahead anyway, since without a card
+// the flash copy is the only one.
+#define PATCH_FLASH_LABEL "patches"
+#define PATCH_FLASH_SUBTYPE 0x40
+#define PATCH_FLASH_MAGIC 0x46313650  // "P61F"
+#define PATCH_FLASH_SECTOR 4096
+#define PATCH_FLASH_RECORDS (PATCH_FLASH_SECTOR / PATCH_RECORD_SIZE)  // Records per sector
+#define PATCH_FLASH_SECTORS (1 + (PATCHES_LIMIT + PATCH_FLASH_RECORDS) / PATCH_FLASH_RECORDS)
+#define PATCH_FLASH_IDLE_SYNC 5000
+#define PATCH_FLASH_MIDI_QUIET 2000
+#define PATCH_FLASH_MAX_DEFER 30000
+
+static_assert(sizeof(PatchMapHeader) + sizeof(slotMap) <= PATCH_FLASH_SECTOR, "Slot map must fit one flash sector");
+
+const esp_partition_t *patchPartition = nullptr;
+const uint8_t *patchFlash = nullptr;  // Mapped partition
+uint16_t patchFlashDirty = 0;         // One bit per sector
+unsigned long patchFlashLastChange = 0;
+unsigned long patchFlashDirtySince = 0;
+uint32_t patchFlashLongestStall = 0;  // us, longest erase and write of one sector
+bool patchFlashSyncQueued = false;
+bool patchCardPresent = false;  // false runs the library from flash alone
+
+bool mapPatchFlash() {
+  if (patchFlash) return true;
+  patchPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)PATCH_FLASH_SUBTYPE, PATCH_FLASH_LABEL);
+  if (!patchPartition || patchPartition->size < PATCH_FLASH_SECTORS * PATCH_FLASH_SECTOR) {
+    Serial.println("No flash partition for patches");
+    return false;
+  }
+  const void *mapped;
+  esp_partition_mmap_handle_t handle;
+  if (esp_partition_mmap(patchPartition, 0, PATCH_FLASH_SECTORS * PATCH_FLASH_SECTOR, ESP_PARTITION_MMAP_DATA, &mapped, &handle) != ESP_OK) {
+    Serial.println("Error mapping patch flash");
+    return false;
+  }
+  patchFlash = (const uint8_t *)mapped;
+  return true;
+}
+
+// Called with the lock held whenever a record or the slot map changes
+void markPatchFlash(int sector) {
+  if (!patchFlash) return;
+  if (!patchFlashDirty) patchFlashDirtySince = millis();
+  patchFlashDirty |= 1 << sector;
+  patchFlashLastChange = millis();
+}
+
+void markPatchFlashRecord(int recordNo) {
+  markPatchFlash(1 + recordNo / PATCH_FLASH_RECORDS);
+}
+
+// Lays out flash sector s from the RAM copies, call with the lock held
+void buildPatchFlashSector(int sector, uint8_t *buf) {
+  memset(buf, 0, PATCH_FLASH_SECTOR);
+  if (sector == 0) {
+    PatchMapHeader header = {};
+    header.magic = PATCH_FLASH_MAGIC;
+    header.version = PATCH_BANK_VERSION;
+    header.slots = PATCHES_LIMIT;
+    header.crc = crc16((const uint8_t *)slotMap, sizeof(slotMap));
+    memcpy(buf, &header, sizeof(header));
+    memcpy(buf + sizeof(header), slotMap, sizeof(slotMap));
+    return;
+  }
+  int first = (sector - 1) * PATCH_FLASH_RECORDS;
+  int count = PATCHES_LIMIT + 1 - first < PATCH_FLASH_RECORDS ? PATCHES_LIMIT + 1 - first : PATCH_FLASH_RECORDS;
+  memcpy(buf, &patchLibrary[first], count * PATCH_RECORD_SIZE);
+}
+
+// Erases and rewrites the first dirty sector whose contents actually changed, the rest stay
+// dirty for the next request
+bool syncPatchFlash() {
+  static uint8_t buf[PATCH_FLASH_SECTOR];
+  if (!patchFlash) return false;
+  for (int sector = 0; sector < PATCH_FLASH_SECTORS; sector++) {
+    lockStorage();
+    bool dirty = patchFlashDirty & (1 << sector);
+    patchFlashDirty &= ~(1 << sector);
+    if (dirty) buildPatchFlashSector(sector, buf);
+    unlockStorage();
+    if (!dirty || memcmp(buf, patchFlash + sector * PATCH_FLASH_SECTOR, PATCH_FLASH_SECTOR) == 0) continue;
+
+    size_t offset = sector * PATCH_FLASH_SECTOR;
+    int64_t started = esp_timer_get_time();
+    bool ok = esp_partition_erase_range(patchPartition, offset, PATCH_FLASH_SECTOR) == ESP_OK
+              && esp_partition_write(patchPartition, offset, buf, PATCH_FLASH_SECTOR) == ESP_OK;
+    uint32_t stall = esp_timer_get_time() - started;
+    if (stall > patchFlashLongestStall) patchFlashLongestStall = stall;
+    if (!ok) Serial.println("Error writing patch flash");
+    Serial.println("Patch flash sector " + String(sector) + " synced, MIDI held off " + String(stall / 1000)
+                   + "ms, longest " + String(patchFlashLongestStall / 1000) + "ms");
+    return ok;
+  }
+  return true;
+}
+
+// Marks every flash sector that differs from the library loaded from the card
+void checkPatchFlash() {
+  static uint8_t buf[PATCH_FLASH_SECTOR];
+  if (!mapPatchFlash()) return;
+  for (int sector = 0; sector < PATCH_FLASH_SECTORS; sector++) {
+    buildPatchFlashSector(sector, buf);
+    if (memcmp(buf, patchFlash + sector * PATCH_FLASH_SECTOR, PATCH_FLASH_SECTOR)) markPatchFlash(sector);
+  }
+}
+
+// The whole map is small enough to go back to the card in a single write. Writes a copy
+// taken under the lock so loop() can carry on changing the map.
+bool saveSlotMap() {
+  static uint16_t map[PATCHES_LIMIT + 1];
+  if (!patchCardPresent) return true;
+  if (!patchMapFile) return false;
+  lockStorage();
+  memcpy(map, slotMap, sizeof(map));
+  unlockStorage();
+
+  PatchMapHeader header = {};
+  header.magic = PATCH_MAP_MAGIC;
+  header.version = PATCH_BANK_VERSION;
+  header.slots = PATCHES_LIMIT;
+  header.crc = crc16((const uint8_t *)map, sizeof(map));
+
+  bool ok = patchMapFile.seek(0)
+            && patchMapFile.write((const uint8_t *)&header, sizeof(header)) == sizeof(header)
+            && patchMapFile.write((const uint8_t *)map, sizeof(map)) == sizeof(map);
+  patchMapFile.flush();
+  if (!ok) Serial.println("Error writing slot map");
+  return ok;
+}
+
+bool queueStorage(uint8_t op, uint16_t recordNo, StorageCallback onComplete);
+
+// Queues the slot map for writing, or marks it for the batch flush
+bool writeSlotMap() {
+  lockStorage();
+  markPatchFlash(0);
+  if (patchBatchOpen) slotMapDirty = true;
+  unlockStorage();
+  if (patchBatchOpen) return true;
+  return queueStorage(STORAGE_WRITE_MAP, 0, nullptr);
+}
+
+// Loads the slot map, or lays one out with patch n in record n for banks that predate it
+bool loadSlotMap() {
+  patchMapFile = SD.open(patchPagePath(PATCH_MAP_FILE), "r+");
+  if (patchMapFile) {
+    PatchMapHeader header;
+    if (patchMapFile.read((uint8_t *)&header, sizeof(header)) == sizeof(header)
+        && header.magic == PATCH_MAP_MAGIC && header.version == PATCH_BANK_VERSION && header.slots == PATCHES_LIMIT
+        && patchMapFile.read((uint8_t *)slotMap, sizeof(slotMap)) == sizeof(slotMap)
+        && header.crc == crc16((const uint8_t *)slotMap, sizeof(slotMap))) {
+      // Never trust a mapping to a record that didn't load
+      for (int i = 1; i <= PATCHES_LIMIT; i++) {
+        if (slotMap[i] > PATCHES_LIMIT || !(patchLibrary[slotMap[i]].flags & PATCH_FLAG_USED)) slotMap[i] = 0;
+      }
+      rebuildRecordMapped();
+      return true;
     }
+    patchMapFile.close();
+  }
+
+  Serial.println("Slot map missing or invalid, rebuilding");
+  for (int i = 0; i <= PATCHES_LIMIT; i++) {
+    slotMap[i] = (i > 0 && (patchLibrary[i].flags & PATCH_FLAG_USED)) ? i : 0;
+  }
+  rebuildRecordMapped();
+  patchMapFile = SD.open(patchPagePath(PATCH_MAP_FILE), FILE_WRITE);
+  if (!patchMapFile) return false;
+  bool ok = saveSlotMap();
+  patchMapFile.close();
+  patchMapFile = SD.open(patchPagePath(PATCH_MAP_FILE), "r+");
+  return ok && patchMapFile;
+}
 
-    data[i++] = String(str);
+int allocateRecord() {
+  for (int i = 1; i <= PATCHES_LIMIT; i++) {
+    if (!isRecordMapped(i)) return i;
   }
+  return 0;
+}
 
-  // Fill remaining fields with empty strings to avoid uninitialized slots
-  while (i < NO_OF_PARAMS) {
-    data[i++] = "";
+// Writes one bank record to RAM and queues it and its manifest entry for the card
+bool writeBankRecord(int recordNo, PatchRecord &rec) {
+  rec.name[PATCH_NAME_LEN] = '\0';
+  rec.crc = patchRecordCrc(rec);
+  unindexSound(recordNo);
+  lockStorage();
+  updateManifestEntry(recordNo, rec);
+  patchLibrary[recordNo] = rec;
+  markPatchFlashRecord(recordNo);
+  if (patchBatchOpen) setBit(recordDirty, recordNo, true);
+  unlockStorage();
+  indexSound(recordNo);
+
+  if (patchBatchOpen) {
+    patchBatchLastWrite = millis();
+    return true;
   }
+  return queueStorage(STORAGE_WRITE_RECORD, recordNo, nullptr);
 }
 
+// Writes records first..first+count-1 and their manifest entries, 32 at a time copied out
+// under the lock, each file written sequentially
+bool writeRecordRun(int first, int count) {
+  static PatchRecord records[32];
+  static PatchManifestEntry entries[32];
+  if (!patchBank) return false;
+
+  bool ok = true;
+  for (int done = 0; done < count && ok;) {
+    int n = count - done < 32 ? count - done : 32;
+    lockStorage();
+    memcpy(records, &patchLibrary[first + done], n * PATCH_RECORD_SIZE);
+    for (int i = 0; i < n; i++) getManifestEntry(first + done + i, entries[i]);
+    unlockStorage();
 
-int compare(const void *a, const void *b) {
-  return ((PatchNoAndName*)a)->patchNo - ((PatchNoAndName*)b)->patchNo;
+    size_t size = (size_t)n * PATCH_RECORD_SIZE;
+    ok = patchBank.seek((uint32_t)(first + done) * PATCH_RECORD_SIZE)
+         && patchBank.write((const uint8_t *)records, size) == size;
+    if (ok && patchManifest) {
+      size = n * sizeof(PatchManifestEntry);
+      ok = patchManifest.seek((uint32_t)(first + done) * sizeof(PatchManifestEntry))
+           && patchManifest.write((const uint8_t *)entries, size) == size;
+    }
+    done += n;
+  }
+  if (!ok) {
+    Serial.print("Error writing patch records from ");
+    Serial.println(first);
+  }
+  return ok;
 }
 
-void sortPatches()
-{
-  int arraySize = patches.size();
-  //Sort patches buffer to be consecutive ascending patchNo order
-  struct PatchNoAndName arrayToSort[arraySize];
+// Writes one record and its manifest entry
+bool saveBankRecord(int recordNo) {
+  if (!patchCardPresent) return true;
+  bool ok = writeRecordRun(recordNo, 1);
+  patchBank.flush();
+  if (patchManifest) {
+    ok = writeManifestHeader() && ok;
+    patchManifest.flush();
+  }
+  return ok;
+}
+
+// Writes everything a batch left dirty
+bool flushPatchBatch() {
+  static uint8_t dirty[sizeof(recordDirty)];
+  unsigned long started = millis();
+  lockStorage();
+  memcpy(dirty, recordDirty, sizeof(dirty));
+  memset(recordDirty, 0, sizeof(recordDirty));
+  bool mapDirty = slotMapDirty;
+  slotMapDirty = false;
+  unlockStorage();
+  if (!patchCardPresent) return true;
+
+  bool ok = true;
+  int runStart = 0;
+  for (int i = 1; i <= PATCHES_LIMIT + 1; i++) {
+    bool isDirty = i <= PATCHES_LIMIT && getBit(dirty, i);
+    if (isDirty && !runStart) runStart = i;
+    if (!isDirty && runStart) {
+      ok = writeRecordRun(runStart, i - runStart) && ok;
+      runStart = 0;
+    }
+  }
+  patchBank.flush();
+  if (patchManifest) {
+    ok = writeManifestHeader() && ok;
+    patchManifest.flush();
+  }
+  if (mapDirty) ok = saveSlotMap() && ok;
+  if (!ok) Serial.println("Error flushing patch batch");
+  Serial.println("Patch batch flushed in " + String(millis() - started) + "ms");
+  return ok;
+}
 
-  for (int i = 0; i < arraySize; ++i)
-  {
-    arrayToSort[i] = patches[i];
+// Implemented in EditJournal.h
+bool flushEditJournal();
+
+bool runStorageRequest(const StorageRequest &req) {
+  switch (req.op) {
+    case STORAGE_WRITE_RECORD:
+      return saveBankRecord(req.recordNo);
+    case STORAGE_WRITE_MAP:
+      return saveSlotMap();
+    case STORAGE_FLUSH_BATCH:
+      return flushPatchBatch();
+    case STORAGE_SYNC_FLASH:
+      return syncPatchFlash();
+    case STORAGE_WRITE_JOURNAL:
+      return flushEditJournal();
+    case STORAGE_BARRIER:
+      storageBarrierDone = true;
+      return true;
   }
-  qsort(arrayToSort, arraySize, sizeof(PatchNoAndName), compare);
-  patches.clear();
+  return false;
+}
 
-  for (int i = 0; i < arraySize; ++i)
-  {
-    patches.push(arrayToSort[i]);
+void storageTaskMain(void *) {
+  StorageRequest req;
+  for (;;) {
+    if (xQueueReceive(storageRequests, &req, portMAX_DELAY) != pdTRUE) continue;
+    StorageResponse res = { req.op, runStorageRequest(req), req.onComplete };
+    if (res.onComplete) xQueueSend(storageResponses, &res, portMAX_DELAY);
   }
 }
 
+// Called from loop(), runs the callbacks of finished requests
+void serviceStorage() {
+  StorageResponse res;
+  while (storageResponses && xQueueReceive(storageResponses, &res, 0) == pdTRUE) {
+    res.onComplete();
+  }
+}
+
+// Hands a write to the storage task, or does it straight away if the task isn't running.
+// Only blocks if STORAGE_QUEUE_LEN requests are already waiting for the card.
+bool queueStorage(uint8_t op, uint16_t recordNo, StorageCallback onComplete) {
+  StorageRequest req = { op, recordNo, onComplete };
+  if (!storageTask) {
+    bool ok = runStorageRequest(req);
+    if (onComplete) onComplete();
+    return ok;
+  }
+  while (xQueueSend(storageRequests, &req, pdMS_TO_TICKS(10)) != pdTRUE) {
+    serviceStorage();  // The task may be waiting for room to post a response
+  }
+  return true;
+}
+
+// Blocks until every queued request has been written
+void waitForStorage() {
+  if (!storageTask) return;
+  storageBarrierDone = false;
+  queueStorage(STORAGE_BARRIER, 0, nullptr);
+  while (!storageBarrierDone) vTaskDelay(1);
+}
+
+// Moves card writes to the storage task, call once the library is loaded
+bool startStorageTask() {
+  if (storageTask) return true;
+  storageMutex = xSemaphoreCreateMutex();
+  storageRequests = xQueueCreate(STORAGE_QUEUE_LEN, sizeof(StorageRequest));
+  storageResponses = xQueueCreate(STORAGE_QUEUE_LEN, sizeof(StorageResponse));
+  if (!storageMutex || !storageRequests || !storageResponses
+      || xTaskCreatePinnedToCore(storageTaskMain, "storage", STORAGE_TASK_STACK, nullptr, STORAGE_TASK_PRIORITY, &storageTask, STORAGE_TASK_CORE) != pdPASS) {
+    Serial.println("Storage task failed to start, writing inline");
+    storageTask = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void beginPatchBatch(StorageCallback onComplete) {
+  if (patchBatchOpen) return;
+  patchBatchComplete = onComplete;
+  patchBatchLastWrite = millis();
+  patchBatchOpen = true;
+}
+
+// Closes the batch and queues its flush, onComplete runs once it is on the card
+bool endPatchBatch() {
+  if (!patchBatchOpen) return true;
+  patchBatchOpen = false;
+  StorageCallback onComplete = patchBatchComplete;
+  patchBatchComplete = nullptr;
+  return queueStorage(STORAGE_FLUSH_BATCH, 0, onComplete);
+}
+
+// Called from loop(), flushes a batch that has stopped receiving patches
+void servicePatchBatch() {
+  if (patchBatchOpen && millis() - patchBatchLastWrite > PATCH_BATCH_IDLE_FLUSH) {
+    endPatchBatch();
+  }
+}
+
+// Saves a patch, overwriting its record in place or taking a free record for a new patch
+bool writePatchRecord(int patchNo, PatchRecord &rec) {
+  if (patchNo < 1 || patchNo > PATCHES_LIMIT) return false;
+
+  int recordNo = slotMap[patchNo];
+  if (recordNo) return writeBankRecord(recordNo, rec);
+
+  recordNo = allocateRecord();
+  if (!recordNo) return false;
+  bool ok = writeBankRecord(recordNo, rec);
+  lockStorage();
+  slotMap[patchNo] = recordNo;
+  unlockStorage();
+  setRecordMapped(recordNo, true);
+  recordPatch[recordNo] = patchNo;
+  return writeSlotMap() && ok;
+}
+
+const PatchRecord *getPatchRecord(int patchNo) {
+  if (patchNo < 1 || patchNo > PATCHES_LIMIT || !slotMap[patchNo]) return nullptr;
+  return &patchLibrary[slotMap[patchNo]];
+}
+
+bool readPatchRecord(int patchNo, PatchRecord &rec) {
+  const PatchRecord *stored = getPatchRecord(patchNo);
+  if (!stored) return false;
+  rec = *stored;
+  return true;
+}
+
+// Removes a patch, every later patch moves down one number. Its record is left as it is
+// on the card and just becomes free for the next new patch.
+void deletePatch(int patchNo) {
+  if (patchNo < 1 || patchNo > PATCHES_LIMIT || !slotMap[patchNo]) return;
+  setRecordMapped(slotMap[patchNo], false);
+  unindexSound(slotMap[patchNo]);
+  lockStorage();
+  memmove(&slotMap[patchNo], &slotMap[patchNo + 1], (PATCHES_LIMIT - patchNo) * sizeof(slotMap[0]));
+  slotMap[PATCHES_LIMIT] = 0;
+  unlockStorage();
+  recordPatchStale = true;
+  writeSlotMap();
+}
+
+// Opens an empty slot at patchNo, moving it and every later patch up one number
+bool insertPatchSlot(int patchNo) {
+  if (patchNo < 1 || patchNo > PATCHES_LIMIT || slotMap[PATCHES_LIMIT]) return false;
+  lockStorage();
+  memmove(&slotMap[patchNo + 1], &slotMap[patchNo], (PATCHES_LIMIT - patchNo) * sizeof(slotMap[0]));
+  slotMap[patchNo] = 0;
+  unlockStorage();
+  recordPatchStale = true;
+  return writeSlotMap();
+}
+
+// Moves count patches starting at from so the first of them becomes patch to,
+// the patches in between close up behind them
+bool movePatchRange(int from, int count, int to) {
+  if (count < 1 || from < 1 || to < 1 || from + count - 1 > PATCHES_LIMIT || to + count - 1 > PATCHES_LIMIT) return false;
+  if (from == to) return true;
+
+  // A move is a rotation of the span covering both ranges
+  uint16_t *first = &slotMap[from < to ? from : to];
+  uint16_t *last = &slotMap[(from < to ? to : from) + count];
+  uint16_t *middle = from < to ? &slotMap[from + count] : &slotMap[from];
+  lockStorage();
+  std::rotate(first, middle, last);
+  unlockStorage();
+  recordPatchStale = true;
+  return writeSlotMap();
+}
+
+// Patch list
+// Names live in a fixed arena of 14 byte slots indexed by patch number, patchList holds the
+// stored patch numbers in order and the pages move a cursor over it instead of rotating
+// the list, so nothing is allocated and going to patch n is a table lookup.
+// patchByName holds the same patch numbers sorted by name (case insensitive, then number).
+// Saving, renaming and deleting update both lists in place, a binary search finds where,
+// so only bulk imports pay for a full rebuild and sort.
+char patchNames[PATCHES_LIMIT + 2][PATCH_NAME_LEN + 1];  // +1 slot for a patch being saved
+uint16_t patchList[PATCHES_LIMIT + 1];                  // Patch numbers in number order
+int16_t patchListPos[PATCHES_LIMIT + 2];                // patchList index of each patch number, -1 if not stored
+uint16_t patchByName[PATCHES_LIMIT + 1];                // Patch numbers in name order
+int patchCount = 0;                                     // Stored patches in patchList
+int patchCursor = 0;                                    // Index of the highlighted patch in the current view
+bool patchPending = false;                              // Save page has a new patch after the last one
+bool patchViewByName = false;                           // Browse in name order instead of number order
+
+// The list the pages browse, in number or name order
+const uint16_t *patchView() {
+  return patchViewByName ? patchByName : patchList;
+}
+
+// Number for a new patch, one after the highest stored
+int nextPatchNo() {
+  return patchCount ? patchList[patchCount - 1] + 1 : 1;
+}
+
+int comparePatchName(const char *name, int patchNo, int otherNo) {
+  int c = strcasecmp(name, patchNames[otherNo]);
+  return c ? c : patchNo - otherNo;
+}
+
+// First position in patchByName not before name/patchNo
+int patchNameIndex(const char *name, int patchNo) {
+  int lo = 0, hi = patchCount;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (comparePatchName(name, patchNo, patchByName[mid]) > 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Rebuilds both lists from the slot map and the RAM copy of the bank
 void loadPatches() {
+  patchCount = 0;
+  patchPending = false;
+  for (int patchNo = 1; patchNo <= PATCHES_LIMIT + 1; patchNo++) {
+    patchListPos[patchNo] = -1;
+    if (patchNo <= PATCHES_LIMIT && slotMap[patchNo]) {
+      memcpy(patchNames[patchNo], patchLibrary[slotMap[patchNo]].name, PATCH_NAME_LEN + 1);
+      patchListPos[patchNo] = patchCount;
+      patchList[patchCount++] = patchNo;
+    }
+  }
+  memcpy(patchByName, patchList, patchCount * sizeof(patchList[0]));
+  std::sort(patchByName, patchByName + patchCount, [](uint16_t a, uint16_t b) {
+    return comparePatchName(patchNames[a], a, b) < 0;
+  });
+  if (patchCursor >= patchCount) patchCursor = 0;
+}
+
+// Adds or refreshes patchNo after it has been saved or renamed
+void indexPatch(int patchNo) {
+  if (patchNo < 1 || patchNo > PATCHES_LIMIT || !slotMap[patchNo]) return;
+  patchPending = false;
+  if (patchListPos[patchNo] >= 0) {
+    int i = patchNameIndex(patchNames[patchNo], patchNo);
+    memmove(&patchByName[i], &patchByName[i + 1], (patchCount - i - 1) * sizeof(patchByName[0]));
+    patchCount--;
+  } else {
+    int i = patchCount;
+    while (i > 0 && patchList[i - 1] > patchNo) {
+      patchList[i] = patchList[i - 1];
+      patchListPos[patchList[i]] = i;
+      i--;
+    }
+    patchList[i] = patchNo;
+    patchListPos[patchNo] = i;
+  }
+  memcpy(patchNames[patchNo], patchLibrary[slotMap[patchNo]].name, PATCH_NAME_LEN + 1);
+  int i = patchNameIndex(patchNames[patchNo], patchNo);
+  memmove(&patchByName[i + 1], &patchByName[i], (patchCount - i) * sizeof(patchByName[0]));
+  patchByName[i] = patchNo;
+  patchCount++;
+}
+
+// Drops patchNo after deletePatch(), every later patch moves down one number as in the slot map
+void unindexPatch(int patchNo) {
+  if (patchNo < 1 || patchNo > PATCHES_LIMIT || patchListPos[patchNo] < 0) return;
+  int i = patchNameIndex(patchNames[patchNo], patchNo);
+  memmove(&patchByName[i], &patchByName[i + 1], (patchCount - i - 1) * sizeof(patchByName[0]));
+  int pos = patchListPos[patchNo];
+  memmove(&patchList[pos], &patchList[pos + 1], (patchCount - pos - 1) * sizeof(patchList[0]));
+  patchListPos[patchNo] = -1;
+  patchCount--;
+  for (i = 0; i < patchCount; i++) {
+    if (patchByName[i] > patchNo) patchByName[i]--;
+  }
+  for (i = pos; i < patchCount; i++) {
+    patchListPos[patchList[i]] = -1;  // Numbers can have gaps, the old one isn't always taken by the next
+    patchList[i]--;
+    patchListPos[patchList[i]] = i;
+  }
+  memmove(patchNames[patchNo], patchNames[patchNo + 1], (PATCHES_LIMIT - patchNo) * sizeof(patchNames[0]));
+  patchPending = false;
+  if (patchCursor >= patchCount) patchCursor = 0;
+}
+
+// True if patchListPos agrees with patchList, logs the first patch number that doesn't
+bool checkPatchIndex() {
+  for (int patchNo = 1; patchNo <= PATCHES_LIMIT; patchNo++) {
+    int pos = patchListPos[patchNo];
+    if (pos >= 0 && (pos >= patchCount || patchList[pos] != patchNo)) {
+      Serial.println("Patch index: " + String(patchNo) + " has stale position " + String(pos));
+      return false;
+    }
+  }
+  for (int i = 0; i < patchCount; i++) {
+    if (patchListPos[patchList[i]] != i) {
+      Serial.println("Patch index: " + String(patchList[i]) + " missing at " + String(i));
+      return false;
+    }
+  }
+  return true;
+}
+
+int patchListSize() {
+  return patchCount + (patchPending ? 1 : 0);
+}
+
+// View index offset entries from the cursor, wrapping at both ends
+int patchListIndex(int offset) {
+  int size = patchListSize();
+  if (size == 0) return -1;
+  return ((patchCursor + offset) % size + size) % size;
+}
+
+int patchNoAt(int offset) {
+  int i = patchListIndex(offset);
+  if (i < 0) return 0;
+  return i < patchCount ? patchView()[i] : nextPatchNo();
+}
+
+const char *patchNameAt(int offset) {
+  int patchNo = patchNoAt(offset);
+  return patchNo ? patchNames[patchNo] : "";
+}
+
+void movePatchCursor(int delta) {
+  int i = patchListIndex(delta);
+  if (i >= 0) patchCursor = i;
+}
+
+// Puts the cursor on patchNo, false if it isn't stored
+bool selectPatch(int patchNo) {
+  if (patchNo < 1 || patchNo > PATCHES_LIMIT || patchListPos[patchNo] < 0) return false;
+  patchCursor = patchViewByName ? patchNameIndex(patchNames[patchNo], patchNo) : patchListPos[patchNo];
+  return true;
+}
+
+// Switches between number and name order, keeping the cursor on the same patch
+void setPatchViewByName(bool byName) {
+  int patchNo = patchCount ? patchNoAt(0) : 0;
+  patchViewByName = byName;
+  selectPatch(patchNo);
+}
+
+// First patch in name order whose name starts with c or, if there is none, the next name
+// after it. Case is ignored, as in the sort. Returns 0 if the list is empty.
+int findPatchPrefix(char c) {
+  if (patchCount == 0) return 0;
+  char key[2] = { c, 0 };
+  int i = patchNameIndex(key, 0);
+  return patchByName[i < patchCount ? i : 0];
+}
+
+// Adds an unsaved patch after the last one for the save page and puts the cursor on it
+bool addPendingPatch() {
+  int patchNo = nextPatchNo();
+  if (patchNo > PATCHES_LIMIT) return false;
+  strncpy(patchNames[patchNo], INITPATCHNAME, PATCH_NAME_LEN);
+  patchNames[patchNo][PATCH_NAME_LEN] = 0;
+  patchPending = true;
+  patchCursor = patchCount;
+  return true;
+}
+
+// Drops the unsaved patch the save page added
+void cancelPendingPatch() {
+  patchPending = false;
+  if (patchCursor >= patchCount) patchCursor = 0;
+}
+
+// Checks the manifest against the bank. Fails if the manifest is missing, its checksum
+// doesn't match its entries, or it disagrees with the bank about which records are used.
+bool loadPatchManifest() {
+  patchManifest = SD.open(patchPagePath(PATCH_MANIFEST_FILE), "r+");
+  if (!patchManifest) return false;
+
+  PatchManifestHeader header;
+  if (patchManifest.read((uint8_t *)&header, sizeof(header)) != sizeof(header)
+      || header.magic != PATCH_MANIFEST_MAGIC || header.version != PATCH_BANK_VERSION || header.slots != PATCHES_LIMIT) {
+    return false;
+  }
+
+  PatchManifestEntry block[32];
+  uint32_t checksum = 0;
+  int recordNo = 1;
+  while (recordNo <= PATCHES_LIMIT) {
+    int count = PATCHES_LIMIT - recordNo + 1;
+    if (count > 32) count = 32;
+    size_t n = patchManifest.read((uint8_t *)block, count * sizeof(PatchManifestEntry)) / sizeof(PatchManifestEntry);
+    if (n == 0) return false;
+
+    for (size_t i = 0; i < n; i++, recordNo++) {
+      checksum += manifestEntryCrc(block[i]);
+      bool used = patchLibrary[recordNo].flags & PATCH_FLAG_USED;
+      if (used != (block[i].recordNo == recordNo)) return false;
+    }
+  }
+  if (checksum != header.checksum) return false;
+
+  manifestChecksum = checksum;
+  return true;
+}
+
+// Reads the whole bank into patchLibrary in one sequential read, checks it against the
+// manifest and builds the patch list from the slot map. Every record is only CRC checked
+// if the manifest can't be trusted.
+bool loadPatchLibrary() {
+  if (!patchBank || !patchBank.seek(0)) return false;
+  size_t size = sizeof(patchLibrary);
+  if (patchBank.read((uint8_t *)patchLibrary, size) != size) {
+    Serial.println("Error reading patch bank");
+    return false;
+  }
+
+  if (!loadPatchManifest()) {
+    Serial.println("Patch manifest missing or stale, rescanning bank");
+    // Drop anything that didn't survive, so the rest of the editor only sees good records
+    for (int i = 1; i <= PATCHES_LIMIT; i++) {
+      if (!isValidPatchRecord(patchLibrary[i])) patchLibrary[i].flags = 0;
+    }
+    writePatchManifest();
+  }
+
+  loadSlotMap();
+  loadPatches();
+  return true;
+}
+
+// Legacy CSV patch files
+// "name,v1,v2,...,v25" as written by the old per-file layout. A whole file is read with a
+// single block read into a stack buffer and the integers are decoded in place, no String
+// objects and no per byte reads.
+#define PATCH_CSV_FIELDS 25
+#define PATCH_CSV_MAX_LEN 256
+
+struct PatchCsvRecord
+{
+  char name[PATCH_NAME_LEN + 1];
+  int16_t values[PATCH_CSV_FIELDS];
+};
+
+// Parses one CSV record from buf, missing trailing fields are left at 0
+bool parsePatchCsv(const char *buf, size_t len, PatchCsvRecord &out) {
+  memset(&out, 0, sizeof(out));
+  const char *p = buf;
+  const char *end = buf + len;
+
+  // Name runs up to the first comma
+  size_t n = 0;
+  while (p < end && *p != ',' && *p != '\n' && *p != '\r') {
+    if (n < PATCH_NAME_LEN) out.name[n++] = *p;
+    p++;
+  }
+  if (p >= end || *p != ',') return n > 0;
+  p++;
+
+  for (int field = 0; field < PATCH_CSV_FIELDS && p < end; field++) {
+    while (p < end && *p == ' ') p++;
+    bool negative = p < end && *p == '-';
+    if (negative) p++;
+    int value = 0;
+    while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+    out.values[field] = negative ? -value : value;
+
+    // Skip to the next field, stop at the end of the line
+    while (p < end && *p != ',' && *p != '\n') p++;
+    if (p >= end || *p == '\n') break;
+    p++;
+  }
+  return true;
+}
+
+bool readPatchCsv(File &patchFile, PatchCsvRecord &out) {
+  char buf[PATCH_CSV_MAX_LEN];
+  size_t len = patchFile.read((uint8_t *)buf, sizeof(buf));
+  return len > 0 && parsePatchCsv(buf, len, out);
+}
+
+// Moves a legacy CSV file from the root into its bucket under PATCH_CSV_DIR
+bool archivePatchFile(int patchNo, const String &name) {
+  char path[32];
+  snprintf(path, sizeof(path), PATCH_CSV_DIR "/%02d", patchNo / PATCH_CSV_SHARD);
+  if (!SD.exists(path) && !SD.mkdir(path)) return false;
+  snprintf(path, sizeof(path), PATCH_CSV_DIR "/%02d/%s", patchNo / PATCH_CSV_SHARD, name.c_str());
+  return SD.rename("/" + name, path);
+}
+
+// One pass over the root for the old one CSV file per patch layout ("/1", "/002", ...). Each
+// file is imported into the bank if importing is set and then moved into its bucket, where
+// it stays untouched as a backup.
+void migratePatchFiles(bool importing) {
   File dir = SD.open("/");
   if (!dir || !dir.isDirectory()) {
     Serial.println("Failed to open SD root");
     return;
   }
 
-  patches.clear();
-
+  int migrated = 0;
+  int archived = 0;
+  unsigned long parseMicros = 0;
   while (true) {
     File patchFile = dir.openNextFile();
     if (!patchFile) break;
 
-    if (patchFile.isDirectory()) {
-      Serial.println("Ignoring directory");
-      continue;
-    }
+    if (patchFile.isDirectory()) continue;
 
-    String name = patchFile.name(); // e.g. "1", "2"
+    String name = patchFile.name();
     if (!name.length() || !isdigit(name[0])) continue;
 
     int patchNo = name.toInt();
-    if (patchNo == 0 && name != "0") continue;  // guard against failed toInt()
-
-    String data[NO_OF_PARAMS];
-    recallPatchData(patchFile, data);
-    patches.push(PatchNoAndName{patchNo, data[0]});
-    Serial.println(name + ":" + data[0]);
+    if (patchNo < 1 || patchNo > PATCHES_LIMIT) continue;
 
+    if (importing) {
+      unsigned long started = micros();
+      PatchCsvRecord csv;
+      bool parsed = readPatchCsv(patchFile, csv);
+      parseMicros += micros() - started;
+      if (parsed) {
+        PatchRecord rec;
+        patchRecordFromCsv(csv, rec);
+        if (writePatchRecord(patchNo, rec)) migrated++;
+      }
+    }
     patchFile.close();
+    if (archivePatchFile(patchNo, name)) archived++;
   }
+  dir.close();
+  if (importing) Serial.println("Migrated " + String(migrated) + " patch files to " + patchPagePath(PATCH_BANK_FILE));
+  if (migrated) Serial.println("CSV read and parse " + String(parseMicros / migrated) + "us per record");
+  if (archived) Serial.println("Moved " + String(archived) + " patch files to " + PATCH_CSV_DIR);
+}
 
-  sortPatches();
+// First boot with the /lib layout, moves a bank, manifest and slot map written to the root
+// by earlier firmware into PATCH_LIB_DIR
+void relocatePatchLibrary() {
+  SD.mkdir(PATCH_LIB_DIR);
+  SD.mkdir(PATCH_CSV_DIR);
+  const char *files[] = { PATCH_BANK_FILE, PATCH_MANIFEST_FILE, PATCH_MAP_FILE };
+  for (const char *file : files) {
+    String from = String("/") + file;
+    String to = String(PATCH_LIB_DIR "/") + file;
+    if (SD.exists(from) && !SD.exists(to)) {
+      SD.rename(from, to);
+      Serial.println("Moved " + from + " to " + to);
+    }
+  }
 }
 
-void savePatch(const char* patchNo, const String& patchData) {
-  char filename[16];
-  snprintf(filename, sizeof(filename), "/%s", patchNo);
+bool createPatchBank() {
+  File bank = SD.open(patchPagePath(PATCH_BANK_FILE), FILE_WRITE);
+  if (!bank) return false;
 
-  if (SD.exists(filename)) {
-    SD.remove(filename);
-  }
+  uint8_t block[PATCH_RECORD_SIZE * 16];
+  memset(block, 0, sizeof(block));
+  PatchBankHeader header = {};
+  header.magic = PATCH_BANK_MAGIC;
+  header.version = PATCH_BANK_VERSION;
+  header.slots = PATCHES_LIMIT;
+  memcpy(block, &header, sizeof(header));
 
-  File patchFile = SD.open(filename, FILE_WRITE);
-  if (patchFile) {
-    patchFile.println(patchData);
-    patchFile.close();
-  } else {
-    Serial.print("Error writing Patch file: ");
-    Serial.println(filename);
+  // Preallocate every slot so the file never has to grow or move on the card
+  size_t remaining = (size_t)(PATCHES_LIMIT + 1) * PATCH_RECORD_SIZE;
+  bool ok = true;
+  while (remaining && ok) {
+    size_t n = remaining < sizeof(block) ? remaining : sizeof(block);
+    ok = bank.write(block, n) == n;
+    memset(block, 0, PATCH_RECORD_SIZE);
+    remaining -= n;
   }
+  bank.close();
+  return ok;
 }
 
-void savePatch(int patchIndex, const String patchData[]) {
-  String dataString = patchData[0];
-  for (int i = 1; i < NO_OF_PARAMS; i++) {
-    dataString += "," + patchData[i];
+// Opens the bank of the current page, creating it if the page is new. Page 0 imports any
+// legacy patch files when it is created; relocating only moves them off the root.
+bool openPatchPage(bool relocating) {
+  String bankFile = patchPagePath(PATCH_BANK_FILE);
+  if (!SD.exists(patchPageDir)) SD.mkdir(patchPageDir);
+
+  if (SD.exists(bankFile)) {
+    unsigned long started = micros();
+    patchBank = SD.open(bankFile, "r+");
+    unsigned long openMicros = micros() - started;
+    PatchBankHeader header;
+    if (patchBank && patchBank.read((uint8_t *)&header, sizeof(header)) == sizeof(header)
+        && header.magic == PATCH_BANK_MAGIC && header.version == PATCH_BANK_VERSION && header.slots == PATCHES_LIMIT) {
+      bool ok = loadPatchLibrary();
+      Serial.println("Patch page " + String(patchPage) + " opened in " + String(openMicros) + "us with " + String(patchCount) + " patches");
+      if (relocating) migratePatchFiles(false);  // Already imported, just clear the root
+      checkPatchFlash();
+      return ok;
+    }
+    // Unknown layout, keep it aside rather than overwrite it
+    if (patchBank) patchBank.close();
+    SD.remove(bankFile + ".bad");
+    SD.rename(bankFile, bankFile + ".bad");
+    Serial.println("Patch bank header invalid, recreating");
   }
 
-  char patchNo[8];
-  snprintf(patchNo, sizeof(patchNo), "%03d", patchIndex);
-  savePatch(patchNo, dataString);
+  if (!createPatchBank()) {
+    Serial.println("Error creating patch bank");
+    return false;
+  }
+  patchBank = SD.open(bankFile, "r+");
+  if (!patchBank) return false;
+  memset(patchLibrary, 0, sizeof(patchLibrary));
+  writePatchManifest();
+  loadSlotMap();
+  beginPatchBatch(loadPatches);
+  if (patchPage == 0) migratePatchFiles(true);
+  endPatchBatch();
+  checkPatchFlash();
+  return true;
 }
 
-void deletePatch(int patchIndex) {
-  char filename[16];
-  snprintf(filename, sizeof(filename), "/%03d", patchIndex);
-  if (SD.exists(filename)) SD.remove(filename);
+// Opens the library at page on boot, moving files left by earlier firmware into /lib first
+bool openPatchBank(int page) {
+  patchCardPresent = true;
+  bool relocating = !SD.exists(PATCH_LIB_DIR);
+  if (relocating) relocatePatchLibrary();
+  patchPage = page >= 0 && page < PATCH_PAGES ? page : 0;
+  setPatchPageDir(patchPage);
+  return openPatchPage(relocating);
 }
 
-void renumberPatchesOnSD() {
-  for (int i = 0; i < patches.size(); i++) {
-    String data[NO_OF_PARAMS];
-    char oldFilename[16];
-    snprintf(oldFilename, sizeof(oldFilename), "/%03d", patches[i].patchNo);
-
-    File file = SD.open(oldFilename);
-    if (file) {
-      recallPatchData(file, data);
-      file.close();
-      savePatch(i + 1, data);  // uses index+1 as new patch number
-    }
-  }
+// Makes page the one in RAM. Every write queued for the current page reaches the card first.
+// The flash copy follows the page in use.
+bool selectPatchPage(int page) {
+  if (page == patchPage) return true;
+  if (page < 0 || page >= PATCH_PAGES || !patchCardPresent) return false;
+  unsigned long started = millis();
+  endPatchBatch();
+  waitForStorage();
 
-  deletePatch(patches.size() + 1);  // delete the trailing duplicate
+  if (patchBank) patchBank.close();
+  if (patchManifest) patchManifest.close();
+  if (patchMapFile) patchMapFile.close();
+  patchPage = page;
+  setPatchPageDir(page);
+  patchCursor = 0;
+  bool ok = openPatchPage(false);
+  loadPatches();  // The new page's list now, not when a batch it started has flushed
+  Serial.println("Switched to patch page " + String(page) + " in " + String(millis() - started) + "ms");
+  return ok;
 }
 
+// Loads the library from the flash copy when there's no card
+bool loadPatchFlash() {
+  patchCardPresent = false;
+  if (!mapPatchFlash()) return false;
+  unsigned long started = micros();
+  const PatchMapHeader *header = (const PatchMapHeader *)patchFlash;
+  const uint16_t *map = (const uint16_t *)(patchFlash + sizeof(PatchMapHeader));
+  if (header->magic != PATCH_FLASH_MAGIC || header->version != PATCH_BANK_VERSION || header->slots != PATCHES_LIMIT
+      || header->crc != crc16((const uint8_t *)map, sizeof(slotMap))) {
+    Serial.println("No patch library in flash");
+    memset(patchLibrary, 0, sizeof(patchLibrary));
+    memset(slotMap, 0, sizeof(slotMap));
+    rebuildRecordMapped();
+    loadPatches();
+    return false;
+  }
 
-void setPatchesOrdering(int no) {
-  if (patches.size() < 2)return;
-  while (patches.first().patchNo != no) {
-    patches.push(patches.shift());
+  memcpy(patchLibrary, patchFlash + PATCH_FLASH_SECTOR, sizeof(patchLibrary));
+  memcpy(slotMap, map, sizeof(slotMap));
+  for (int i = 1; i <= PATCHES_LIMIT; i++) {
+    if (slotMap[i] > PATCHES_LIMIT || !isValidPatchRecord(patchLibrary[slotMap[i]])) slotMap[i] = 0;
   }
+  rebuildRecordMapped();
+  loadPatches();
+  Serial.println("Loaded " + String(patchCount) + " patches from flash in " + String(micros() - started) + "us");
+  return true;
+}
+
+void patchFlashSynced() {
+  patchFlashSyncQueued = false;
 }
 
-void resetPatchesOrdering() {
-  setPatchesOrdering(1);
+// Called from loop(), queues a sector of flash sync once edits have settled and MIDI is quiet
+void servicePatchFlash() {
+  if (patchFlashDirty && !patchFlashSyncQueued && millis() - patchFlashLastChange > PATCH_FLASH_IDLE_SYNC
+      && (midiQuiet(PATCH_FLASH_MIDI_QUIET) || millis() - patchFlashDirtySince > PATCH_FLASH_MAX_DEFER)) {
+    patchFlashSyncQueued = true;
+    queueStorage(STORAGE_SYNC_FLASH, 0, patchFlashSynced);
+  }
 }
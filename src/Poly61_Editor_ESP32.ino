@@ -6,7 +6,6 @@
     ElectroTechnique for general method of menus and updates.
 
   Additional libraries:
-    Agileware CircularBuffer available in Arduino libraries manager
 */
 
 #include <Wire.h>
@@ -17,7 +16,10 @@
 #include "MidiCC.h"
 #include "Constants.h"
 #include "Parameters.h"
+#include "MidiPort.h"
 #include "PatchMgr.h"
+#include "SyxMgr.h"
+#include "EditJournal.h"
 #include "Button.h"
 #include "HWControls.h"
 #include "EepromMgr.h"
@@ -33,6 +35,7 @@
 #define DELETEMSG 7      //Delete patch message page
 #define SETTINGS 8       //Settings page
 #define SETTINGSVALUE 9  //Settings page
+#define PATCHJUMP 10     //Jump through patches list by name prefix
 
 unsigned int state = PARAMETER;
 
@@ -42,13 +45,16 @@ boolean cardStatus = false;
 
 
 //MIDI 5 Pin DIN
-MIDI_CREATE_INSTANCE(HardwareSerial, Serial2, MIDI);
+MidiPort midiPort(Serial2);  // Paced output lanes, see MidiPort.h
+midi::MidiInterface<MidiPort> MIDI(midiPort);
 //MIDI_CREATE_INSTANCE(HardwareSerial, Serial2, MIDI5);
 
 #include "Settings.h"
 
 int patchNo = 1;  //Current patch no
 
+SyxDecoder midiSyx;  // Incoming SysEx, fed a byte at a time by the MIDI port
+
 void pollAllMCPs();
 
 void initRotaryEncoders();
@@ -57,6 +63,8 @@ void initButtons();
 
 int getEncoderSpeed(int id);
 
+extern int *const patchParams[PATCH_CSV_FIELDS];
+
 void setup() {
 
   Serial.begin(115200);
@@ -110,19 +118,28 @@ void setup() {
 
   // --- Initialize SD ---
 
+  // Loads the library and the patch list, must be called before encoder logic
+  patchViewByName = getBrowseByName();
+  importSkipDuplicates = getSkipDuplicates();
   if (!SD.begin(13)) {  // CS pin
-    Serial.println("SD card mount failed!");
-    while (1)
-      ;
+    Serial.println("SD card mount failed, running from the flash copy");
+    loadPatchFlash();
+  } else {
+    Serial.println("SD card mounted.");
+    cardStatus = true;
+    if (!openPatchBank(getPatchPage())) {
+      Serial.println("Patch bank unavailable!");
+    }
   }
-
-  Serial.println("SD card mounted.");
-  loadPatches();  // Must be called before encoder logic
-  if (patches.isEmpty()) {
+  startStorageTask();  // Card writes from here on run in the background
+  beginEditJournal(patchParams, PATCH_CSV_FIELDS);
+  if (patchListSize() == 0) {
     //Serial.println("⚠️ No patches found after loadPatches()");
   } else {
-    patchNo = patches.first().patchNo;
-    recallPatch(patchNo);  // Optional: auto-load first patch
+    storedLastPatch = getLastPatch();
+    int journalPatch = editJournalPatch();  // Unsaved edits from the last session apply to this one
+    selectPatch(journalPatch ? journalPatch : storedLastPatch);  // Back to the patch in use at power off, else the first
+    patchNo = patchNoAt(0);  // Recalled once MIDI and its settings are up
   }
 
   //Read MIDI Channel from EEPROM
@@ -132,17 +149,18 @@ void setup() {
 
   //Read UpdateParams type from EEPROM
   updateParams = getUpdateParams();
+  recallSysEx = getRecallSysEx();
+  midiSysExGapUs = getSysExGap() * 1000;
 
   //MIDI 5 Pin DIN
+  Serial2.setRxBufferSize(MIDI_RX_BUFFER);
   Serial2.begin(31250, SERIAL_8N1, 16, 17);  // RX, TX
   MIDI.begin();
   MIDI.setHandleControlChange(myConvertControlChange);
   MIDI.setHandleProgramChange(myProgramChange);
-  MIDI.setHandleNoteOn(myNoteOn);
-  MIDI.setHandleNoteOff(myNoteOff);
-  MIDI.setHandlePitchBend(myPitchBend);
-  MIDI.setHandleAfterTouchChannel(myAfterTouch);
-  MIDI.setHandleSystemExclusive(handleSysexByte);
+  midiPort.setThruFilter(midiThruFilter);
+  syxBegin(midiSyx, receiveSysExPatch);
+  midiPort.setHandleSysExByte(receiveSysExByte);
   MIDI.turnThruOn(midi::Thru::Mode::Off);
   Serial.println("MIDI In DIN Listening");
 
@@ -162,6 +180,9 @@ void setup() {
   afterTouch = getAfterTouch();
 
   recallPatch(patchNo);  //Load first patch
+  if (replayEditJournal(patchNo)) {
+    sendToSynthData();  // Unsaved edits from before power off
+  }
   refreshScreen();
 }
 
@@ -177,165 +198,177 @@ void initButtons() {
   }
 }
 
-void myNoteOn(byte channel, byte note, byte velocity) {
-  if (!recallPatchFlag) {
-    MIDI.sendNoteOn(note, velocity, channel);
-  }
-}
-
-void myNoteOff(byte channel, byte note, byte velocity) {
-  if (!recallPatchFlag) {
-    MIDI.sendNoteOff(note, velocity, channel);
+// MIDI thru is decided a byte at a time as messages come off the UART, see MidiPort.h. Notes,
+// bend and the performance CCs go straight to the synth, only the CCs myControlChange()
+// follows and program changes wait for MIDI.read() in loop().
+bool isEditorCC(byte number) {
+  switch (number) {
+    case CCosc1_PWM:
+    case CCosc2_interval:
+    case CCosc2_detune:
+    case CCvcf_cutoff:
+    case CCvcf_res:
+    case CCvcf_eg_depth:
+    case CCvcf_key_follow:
+    case CCvca_gate:
+    case CCkey_rotate:
+    case CClfo1_speed:
+    case CClfo1_delay:
+    case CClfo1_vcf:
+    case CClfo2_speed:
+    case CCeg1_attack:
+    case CCeg1_decay:
+    case CCeg1_release:
+    case CCeg1_sustain:
+    case CCosc1_octave:
+    case CCosc2_octave:
+    case CCosc1_wave:
+    case CCosc2_wave:
+    case CClfo1_wave:
+    case CClfo2_wave:
+    case CClfo_src:
+    case CCallnotesoff:
+      return true;
   }
+  return false;
 }
 
-void handleSysexByte(byte *data, unsigned length) {
-  if (length < 6) return;  // safety: need at least header + F7
+MidiThruAction midiThruFilter(byte *msg, byte &len) {
+  byte type = msg[0] & 0xF0;
+  if (midiChannel != MIDI_CHANNEL_OMNI && (msg[0] & 0x0F) != midiChannel - 1) return MIDI_THRU_DROP;
+  switch (type) {
+    case 0x80:
+    case 0x90:
+      return MIDI_THRU_SEND;  // Notes keep their channel
 
-  dumpType = data[4];  // 5th byte in header determines type
+    case 0xB0:
+      if (msg[1] == CCmasterVolume) {
+        msg[1] = 96;
+      } else if (isEditorCC(msg[1])) {
+        return MIDI_THRU_PARSE;
+      }
+      break;
 
-  switch (dumpType) {
-    case 0x31:  // ---- Poly61 style, 1926 bytes, no names ----
-      {
-        // Reset state
-        receivingSysEx = true;
-        byteIndex = 0;
-        currentBlock = 0;
-        headerSkip = 0;
+    case 0xC0:
+      return MIDI_THRU_PARSE;
 
-        // Skip the 5-byte header and tail F7
-        unsigned payloadLen = length - 6;
+    case 0xD0:
+      if (!afterTouch) return MIDI_THRU_DROP;
+      msg[2] = msg[1];  // As the mod wheel
+      msg[1] = 1;
+      len = 3;
+      type = 0xB0;
+      break;
+  }
+  msg[0] = type | ((midiOutCh - 1) & 0x0F);
+  if (type == 0xB0) ccMirror[msg[1]] = CC_UNSENT;  // Thru changed it behind midiCCOut()'s back, e.g. mod wheel on lfo1_vco
+  return MIDI_THRU_SEND;
+}
 
-        for (unsigned i = 0; i < payloadLen; i++) {
-          ramArray[currentBlock][byteIndex] = data[i + 5];
-          byteIndex++;
+// Incoming SysEx never goes through the MIDI library. MidiPort hands each byte to
+// receiveSysExByte() as it comes off the UART, the decoder turns every 24 nibbles into a
+// packed patch, and each patch is stored or sent on as soon as it is complete, so a dump
+// needs one patch of RAM and the panel stays live while it arrives.
+#define SYSEX_PROGRESS_INTERVAL 100  // ms between progress redraws, the log gets every patch
 
-          if (byteIndex >= 24) {  // 24 nibbles = 12 bytes
-            byteIndex = 0;
-            currentBlock++;
-          }
-        }
+unsigned long sysexProgressAt = 0;
 
-        if (currentBlock >= 80) {
-          sysexComplete = true;
-          receivingSysEx = false;
-          Serial.println("Processed sysex (0x01 bank without names)");
-        }
-      }
-      break;
+void receiveSysExByte(byte b) {
+  syxFeed(midiSyx, b);
+  receivingSysEx = midiSyx.inMessage;
+}
 
-    case 0x02:  // ---- Single patch with name ----
-      processSinglePatch(&data[5], length - 6);
-      recallPatchFlag = true;
-      sendToSynthData();
-      updatePatchname();
-      startParameterDisplay();
-      recallPatchFlag = false;
+void receiveSysExPatch(byte type, int index, const char *name, const byte *packed) {
+  switch (type) {
+    case SYX_BANK:
+      processBankDumpPatch(index, packed);
       break;
 
-    case 0x03:  // ---- Bank of 80 patches with names ----
-      processBankPatch(&data[5], length - 6);
+    case SYX_SINGLE:
+      processSinglePatch(name, packed);
       break;
 
-    default:
-      Serial.print("Unknown SysEx dump type: 0x");
-      Serial.println(dumpType, HEX);
+    case SYX_BANK_NAMED:
+      processBankPatch(name, packed);
       break;
   }
 }
 
-void processSinglePatch(byte *payload, unsigned len) {
-  if (len < 50) return;  // need 50 nibbles (26 name + 24 patch)
+void showSysExProgress(int received) {
+  Serial.println("Received patch " + String(received) + "/" + String(NUM_PATCHES) + ": " + patchName);
+  if (received < NUM_PATCHES && millis() - sysexProgressAt < SYSEX_PROGRESS_INTERVAL) return;
+  sysexProgressAt = millis();
+  showCurrentParameterPage("Receiving", "Patch " + String(received) + "/" + String(NUM_PATCHES));
+  startParameterDisplay();
+}
 
-  // First 26 nibbles = patch name (13 bytes)
-  char name[14];
-  for (int i = 0; i < 13; i++) {
-    byte hi = payload[i * 2];
-    byte lo = payload[i * 2 + 1];
-    name[i] = ((hi & 0x0F) << 4) | (lo & 0x0F);
+// One patch of a 0x31 dump (80 patches without names in one message)
+void processBankDumpPatch(int index, const byte *packed) {
+  if (index >= NUM_PATCHES) return;
+  int bankStart = bankStartPatch();
+  if (index == 0) {
+    importDuplicates = 0;
+    beginPatchBatch(loadPatches);
   }
-  name[13] = '\0';
-  patchName = String(name);
 
-  // Next 24 nibbles = patch data (12 bytes)
-  byte patchBytes[12];
-  int offset = 26;
-  for (int i = 0; i < 12; i++) {
-    byte hi = payload[(offset + i * 2)];
-    byte lo = payload[(offset + i * 2) + 1];
-    patchBytes[i] = ((hi & 0x0F) << 4) | (lo & 0x0F);
+  decodePatch(packed);
+  patchName = "Sysex " + String(bankStart + index);
+  saveImportedPatch(bankStart + index);
+  showSysExProgress(index + 1);
+
+  if (index == NUM_PATCHES - 1) {
+    endPatchBatch();
+    reportImportDuplicates();
+    recallPatch(bankStart);  // First patch in the current bank
+    state = PARAMETER;
+    startParameterDisplay();
   }
+}
 
-  // Decode into current patch memory (don’t save yet)
-  decodePatch(patchBytes);
+// A 0x02 single patch, loaded and sent to the synth but not saved
+void processSinglePatch(const char *name, const byte *packed) {
+  patchName = String(name);
+  decodePatch(packed);
   Serial.print("Loaded single patch: ");
   Serial.println(patchName);
+  recallPatchFlag = true;
+  sendToSynthData();
+  updatePatchname();
+  startParameterDisplay();
+  recallPatchFlag = false;
 }
 
-void processBankPatch(byte *payload, unsigned len) {
-  if (len < 50) return;  // 26 nibbles name + 24 nibbles data
+// One 0x03 message, patches arrive one per message and fill the bank chosen in Set Bank
+void processBankPatch(const char *name, const byte *packed) {
+  int bankStart = bankStartPatch();
 
-  // ---- Extract patch name ----
-  char name[14];
-  for (int i = 0; i < 13; i++) {
-    byte hi = payload[i * 2];
-    byte lo = payload[i * 2 + 1];
-    name[i] = ((hi & 0x0F) << 4) | (lo & 0x0F);
-  }
-  name[13] = '\0';
-  patchName = String(name);
-
-  // ---- Extract patch params ----
-  byte patchBytes[12];
-  int offset = 26;
-  for (int i = 0; i < 12; i++) {
-    byte hi = payload[offset + i * 2];
-    byte lo = payload[offset + i * 2 + 1];
-    patchBytes[i] = ((hi & 0x0F) << 4) | (lo & 0x0F);
-  }
-
-  // Decode + save to correct slot in selected bank
-  int bankStart = 1;
-  switch (bankselect) {
-    case 0: bankStart = 1; break;
-    case 1: bankStart = 81; break;
-    case 2: bankStart = 161; break;
-    case 3: bankStart = 241; break;
-    case 4: bankStart = 301; break;
+  if (bankPatchCounter > 0 && !patchBatchOpen) bankPatchCounter = 0;  // The last bank was cut short and its batch closed
+  if (bankPatchCounter == 0) {
+    importDuplicates = 0;
+    beginPatchBatch(loadPatches);
   }
 
-  decodePatch(patchBytes);
-  sprintf(buffer, "%d", bankStart + bankPatchCounter);
-  savePatch(buffer, getCurrentPatchData());
-  updatePatchname();
+  patchName = String(name);
+  decodePatch(packed);
+  saveImportedPatch(bankStart + bankPatchCounter);
 
   bankPatchCounter++;
+  showSysExProgress(bankPatchCounter);
 
   // If we've now got all 80, finish the bank
-  if (bankPatchCounter >= 80) {
-    loadPatches();
+  if (bankPatchCounter >= NUM_PATCHES) {
+    endPatchBatch();
+    reportImportDuplicates();
     bankPatchCounter = 0;
     showCurrentParameterPage("Finished", String("Sysex Load"));
     startParameterDisplay();
-    delay(50);
     recallPatch(bankStart);
     startParameterDisplay();
   }
 }
 
-void convertNibblesToBytes() {
-  for (int p = 0; p < NUM_PATCHES; p++) {
-    for (int b = 0; b < PATCH_BYTES; b++) {
-      byte hi = ramArray[p][b * 2];      // high nibble
-      byte lo = ramArray[p][b * 2 + 1];  // low nibble
-      receivedPatches[p][b] = ((hi & 0x0F) << 4) | (lo & 0x0F);
-    }
-  }
-  Serial.println("Converted nibbles to 12-byte patches");
-}
-
 // ------------------- Single Patch Decode -------------------
-void decodePatch(byte *src) {
+void decodePatch(const byte *src) {
   // ---- Envelope 1 ----
   eg1_attack = (src[0] & 0x7F);   // ATT0–ATT6
   eg1_decay = (src[1] & 0x7F);    // DEC0–DEC6
@@ -378,42 +411,15 @@ void decodePatch(byte *src) {
   vcf_eg_depth = src[9] & 0x07;      // EGI0–EGI2
 }
 
-void decodePatches() {
-
-  int bankStart = 1;
+// First patch number of the bank chosen in Set Bank
+int bankStartPatch() {
   switch (bankselect) {
-    case 0: bankStart = 1; break;
-    case 1: bankStart = 81; break;
-    case 2: bankStart = 161; break;
-    case 3: bankStart = 241; break;
-    case 4: bankStart = 301; break;
+    case 1: return 81;
+    case 2: return 161;
+    case 3: return 241;
+    case 4: return 301;
   }
-  for (int p = 0; p < NUM_PATCHES; p++) {
-    // Decode one patch into globals
-    decodePatch(receivedPatches[p]);
-
-    // Replace name completely
-
-    patchName = "Sysex " + String(bankStart + p);
-
-    sprintf(buffer, "%d", p + bankStart);
-    savePatch(buffer, getCurrentPatchData());
-    updatePatchname();
-  }
-
-  loadPatches();
-
-  // Recall first patch in the current bank
-  switch (bankselect) {
-    case 0: recallPatch(1); break;
-    case 1: recallPatch(81); break;
-    case 2: recallPatch(161); break;
-    case 3: recallPatch(241); break;
-    case 4: recallPatch(301); break;
-  }
-
-  state = PARAMETER;
-  startParameterDisplay();
+  return 1;
 }
 
 // Packs current patch parameters into 12-byte array for SysEx dump
@@ -454,90 +460,38 @@ void sendSysexDump() {
     showCurrentParameterPage("Processing", String("Sysex Send"));
     startParameterDisplay();
 
-    const byte header[5] = { 0xF0, 0x42, 0x50, 0x36, 0x31 };
-    const byte tail = 0xF7;
-
-    // Total = 5 header + (80*24 nibbles) + 1 tail = 1926
-    static byte sysexBuffer[1926];
-    int idx = 0;
-
-    // Copy header
-    for (int i = 0; i < 5; i++) {
-      sysexBuffer[idx++] = header[i];
-    }
-
-    // Encode 80 patches
-    for (int p = 0; p < 80; p++) {
-      updateParams = false;
-      recallPatch(p + 1);
-
-      byte packed[12];
-      encodePatch(p, packed);
-
-      // Split into 24 nibbles
-      for (int i = 0; i < 12; i++) {
-        sysexBuffer[idx++] = (packed[i] >> 4) & 0x0F;  // high nibble
-        sysexBuffer[idx++] = packed[i] & 0x0F;         // low nibble
-      }
-    }
-
-    // Add SysEx end
-    sysexBuffer[idx++] = tail;
-
-    // ✅ Send in one go using the MIDI library
-    MIDI.sendSysEx(idx, sysexBuffer, true);
-
-    // or raw UART if you like:
-    // Serial2.write(sysexBuffer, idx);
+    // Packed straight from the stored records onto the SysEx lane, the live patch isn't touched
+    unsigned long started = micros();
+    MidiSysExStream out(midiPort);
+    static SyxWriter w;
+    w = { &out, {}, 0, true };
+    out.begin();
+    syxPutBank(w, 1);
+    syxFlush(w);
+    out.end();
+    ccMirrorValid = false;
+    Serial.println("Bank dump encoded and queued in " + String(micros() - started) + "us");
 
     saveAll = false;
     storeSaveAll(saveAll);
     settings::decrement_setting_value();
     settings::save_current_value();
     showSettingsPage();
-    delay(100);
     sendingSysEx = false;
     state = PARAMETER;
-    recallPatch(1);
-    recallPatchFlag = false;
-    updateParams = true;
+    startParameterDisplay();
   }
 }
 
-void sendPatchWithHeader(const String &patchName, int patchIndex, byte headerType) {
-  byte buffer[64];
-  int idx = 0;
-
-  // Header: last byte = headerType (0x02 = single, 0x03 = bank)
-  buffer[idx++] = 0xF0;  // SysEx start
-  buffer[idx++] = 0x42;  // Korg ID
-  buffer[idx++] = 0x50;  // Model ID
-  buffer[idx++] = 0x36;  // Device/channel
-  buffer[idx++] = headerType;
-
-  // Patch name (13 chars → 26 nibbles)
-  char name[14];
-  strncpy(name, patchName.c_str(), 13);
-  name[13] = '\0';
-  for (int i = 0; i < 13; i++) {
-    byte c = (byte)name[i];
-    buffer[idx++] = (c >> 4) & 0x0F;
-    buffer[idx++] = c & 0x0F;
-  }
-
-  // Patch data (12 bytes → 24 nibbles)
-  recallPatch(patchIndex);
-  byte packed[12];
-  encodePatch(patchIndex, packed);
-  for (int i = 0; i < 12; i++) {
-    buffer[idx++] = (packed[i] >> 4) & 0x0F;
-    buffer[idx++] = packed[i] & 0x0F;
-  }
-
-  buffer[idx++] = 0xF7;  // SysEx end
-
-  // Send SysEx over MIDI
-  MIDI.sendSysEx(idx, buffer, true);
+// One stored patch as a named patch message (SYX_SINGLE or SYX_BANK_NAMED), an empty slot
+// goes out blank. The live patch isn't touched.
+void sendStoredPatch(int patchNo, byte type) {
+  static const PatchRecord blank = {};
+  const PatchRecord *rec = getPatchRecord(patchNo);
+  byte msg[SYX_NAMED_PATCH_LEN];
+  syxBuildNamedPatch(msg, type, rec ? *rec : blank);
+  MIDI.sendSysEx(sizeof(msg), msg, true);
+  ccMirrorValid = false;
 }
 
 void sendSinglePatch(int patchIndex) {
@@ -545,14 +499,12 @@ void sendSinglePatch(int patchIndex) {
     sendingSysEx = true;
     showCurrentParameterPage("Sending", String("Current Patch"));
     startParameterDisplay();
-    recallPatch(patchIndex);
-    sendPatchWithHeader(patchName, patchIndex, 0x02);  // headerType = 0x02
+    sendStoredPatch(patchIndex, SYX_SINGLE);
     saveCurrent = false;
     storeSaveCurrent(saveCurrent);
     settings::decrement_setting_value();
     settings::save_current_value();
     showSettingsPage();
-    delay(100);
     sendingSysEx = false;
     state = PARAMETER;
     startParameterDisplay();
@@ -561,74 +513,145 @@ void sendSinglePatch(int patchIndex) {
   }
 }
 
+// "Send All" pipeline. The 0x03 messages are built from the stored records while the ones
+// before them drain, keeping about BANK_SEND_AHEAD of them on the SysEx lane, so the send is
+// bound by wire time plus the SysEx Gap setting. serviceBankSend() runs it from loop().
+#define BANK_SEND_AHEAD 2
+
+int bankSendNext = 0;  // Next patch to queue, 0 when not sending
+unsigned long bankSendStarted = 0;
+unsigned long bankSendProgressAt = 0;
+
 void sendBankDump() {
-  if (saveEditorAll) {
-    sendingSysEx = true;
+  if (saveEditorAll && !bankSendNext) {
     sendingSysEx = true;
+    bankSendNext = 1;
+    bankSendStarted = millis();
+    resetMidiSysExGaps();
     showCurrentParameterPage("Sending", String("All Patches"));
-    for (int p = 0; p < 80; p++) {
-      recallPatch(p + 1);
-      sendPatchWithHeader(patchName, p + 1, 0x03);  // headerType = 0x03
-      delay(5);                                     // small pause between sends
-    }
-    saveEditorAll = false;
-    storeSaveEditorAll(saveEditorAll);
-    settings::decrement_setting_value();
-    settings::save_current_value();
-    showSettingsPage();
-    delay(100);
-    sendingSysEx = false;
-    state = PARAMETER;
-    recallPatch(1);
     startParameterDisplay();
-    recallPatchFlag = false;
-    updateParams = true;
   }
 }
 
-void myConvertControlChange(byte channel, byte number, byte value) {
-  if (!recallPatchFlag) {
-    switch (number) {
-
-      case 0:
-        MIDI.sendControlChange(number, value, midiOutCh);
-        break;
-
-      case 1:
-        MIDI.sendControlChange(number, value, midiOutCh);
-        break;
-
-      case 2:
-        MIDI.sendControlChange(number, value, midiOutCh);
-        break;
+void serviceBankSend() {
+  if (!bankSendNext) return;
+  while (bankSendNext <= NUM_PATCHES && midiLaneUsed(MIDI_LANE_SYSEX) < BANK_SEND_AHEAD * SYX_NAMED_PATCH_LEN) {
+    sendStoredPatch(bankSendNext, SYX_BANK_NAMED);
+    if (bankSendNext == NUM_PATCHES || millis() - bankSendProgressAt >= SYSEX_PROGRESS_INTERVAL) {
+      bankSendProgressAt = millis();
+      showCurrentParameterPage("Sending", "Patch " + String(bankSendNext) + "/" + String(NUM_PATCHES));
+      startParameterDisplay();
+    }
+    bankSendNext++;
+  }
+  if (bankSendNext <= NUM_PATCHES || !midiOutIdle(1 << MIDI_LANE_SYSEX)) return;  // Notes and thru don't hold it open
+
+  Serial.println("Sent " + String(NUM_PATCHES) + " patches in " + String(millis() - bankSendStarted) + "ms, SysEx gap set "
+                 + String(midiSysExGapUs) + "us, measured " + String(midiSysExGapAverage()) + "us");
+  bankSendNext = 0;
+  saveEditorAll = false;
+  storeSaveEditorAll(saveEditorAll);
+  settings::decrement_setting_value();
+  settings::save_current_value();
+  showSettingsPage();
+  sendingSysEx = false;
+  state = PARAMETER;
+  startParameterDisplay();
+}
 
-      case 7:
-        MIDI.sendControlChange(96, value, midiOutCh);
-        break;
+// Remembers the patch in use once it has stayed put for LAST_PATCH_STORE_DELAY, so
+// browsing through patches doesn't write the EEPROM on every step
+void checkLastPatch() {
+  static int pendingPatch = 0;
+  static unsigned long changedAt = 0;
+  if (patchNo != pendingPatch) {
+    pendingPatch = patchNo;
+    changedAt = millis();
+  }
+  if (pendingPatch != storedLastPatch && millis() - changedAt > LAST_PATCH_STORE_DELAY) {
+    storeLastPatch(pendingPatch);
+    storedLastPatch = pendingPatch;
+  }
+}
 
-      case 64:
-        MIDI.sendControlChange(number, value, midiOutCh);
-        break;
+// Keeps the last patch in EEPROM on the same sound when patchNo is deleted and later ones
+// move down, or back to the first if it was the one deleted
+void lastPatchDeleted(int deleted) {
+  if (storedLastPatch < deleted) return;
+  storedLastPatch = storedLastPatch > deleted ? storedLastPatch - 1 : 1;
+  storeLastPatch(storedLastPatch);
+}
 
-      default:
-        int newvalue = value;
-        myControlChange(channel, number, newvalue);
-        break;
+// Loads the library page chosen in settings and recalls its first patch
+void checkPatchPage() {
+  if (patchPageRequest < 0) return;
+  int page = patchPageRequest;
+  patchPageRequest = -1;
+  showCurrentParameterPage("Loading", "Page " + String(page + 1));
+  startParameterDisplay();
+  if (selectPatchPage(page)) {
+    storePatchPage(page);
+    if (patchListSize() > 0) {
+      patchNo = patchNoAt(0);
+      recallPatch(patchNo);
     }
+  } else {
+    showCurrentParameterPage("Patch Page", String("Unavailable"));
   }
+  state = PARAMETER;
+  startParameterDisplay();
 }
 
-void myPitchBend(byte channel, int bend) {
-  if (!recallPatchFlag) {
-    MIDI.sendPitchBend(bend, midiOutCh);
+// Runs a .syx import or export chosen in the settings menu
+void checkSyxTransfer() {
+  if (!syxImport && !syxExport) return;
+  char path[24];
+  int first = 0;
+
+  if (!patchCardPresent) {
+    showCurrentParameterPage("Syx Files", String("No SD card"));
+  } else if (syxImport) {
+    showCurrentParameterPage("Importing", String("Syx File"));
+    startParameterDisplay();
+    first = syxImport == SYX_TRANSFER_BANK ? bankStartPatch() : 1;
+    if (syxImport == SYX_TRANSFER_BANK) {
+      snprintf(path, sizeof(path), SYX_DIR "/BANK%d.SYX", bankselect);
+    } else {
+      strcpy(path, SYX_LIBRARY_FILE);
+    }
+    int imported = importSyxFile(path, first);
+    showCurrentParameterPage("Imported", String(imported) + " patches");
+  } else {
+    showCurrentParameterPage("Exporting", String("Syx File"));
+    startParameterDisplay();
+    bool ok = false;
+    if (syxExport == SYX_TRANSFER_PATCH) {
+      snprintf(path, sizeof(path), SYX_DIR "/P%03d.SYX", patchNo);
+      ok = exportSyxPatch(path, patchNo);
+    } else if (syxExport == SYX_TRANSFER_BANK) {
+      snprintf(path, sizeof(path), SYX_DIR "/BANK%d.SYX", bankselect);
+      ok = exportSyxBank(path, bankStartPatch());
+    } else {
+      strcpy(path, SYX_LIBRARY_FILE);
+      ok = exportSyxLibrary(path);
+    }
+    showCurrentParameterPage(ok ? "Exported" : "Export failed", String(path));
   }
+
+  // Back to "No", the handler clears the request
+  settings::decrement_setting_value();
+  settings::decrement_setting_value();
+  settings::decrement_setting_value();
+  settings::save_current_value();
+  state = PARAMETER;
+  if (first) recallPatch(first);
+  startParameterDisplay();
 }
 
-void myAfterTouch(byte channel, byte value) {
+void myConvertControlChange(byte channel, byte number, byte value) {
   if (!recallPatchFlag) {
-    if (afterTouch) {
-      MIDI.sendControlChange(1, value, midiOutCh);
-    }
+    int newvalue = value;
+    myControlChange(channel, number, newvalue);
   }
 }
 
@@ -1370,79 +1393,88 @@ void myProgramChange(byte channel, byte program) {
   state = PARAMETER;
 }
 
+// Loads patchNo and queues it for the synth. Nothing sleeps or waits for the wire: the MIDI port
+// paces it out, and a later recall replaces whatever of this one hasn't gone out yet, so notes
+// keep flowing while patches are scrolled through.
 void recallPatch(int patchNo) {
   allNotesOff();
-
-  if (!sendingSysEx) {
-    if (!updateParams) {
-      MIDI.sendProgramChange(patchNo - 1, midiOutCh);
-    }
+  if (!sendingSysEx && !updateParams) {
+    MIDI.sendProgramChange(patchNo - 1, midiOutCh);  // The param lane holds CCs back while the synth catches up
+    ccMirrorValid = false;                           // The synth loads its own copy
   }
 
-  delay(50);  // Let synth catch up
+  PatchRecord rec;
+  bool stored = readPatchRecord(patchNo, rec);
   recallPatchFlag = true;
+  if (stored) setCurrentPatchData(rec);
+  recallPatchFlag = false;
+  startEditJournal(patchNo);
 
-  // Format filename without zero-padding
-  char filename[16];
-  snprintf(filename, sizeof(filename), "/%d", patchNo);  // e.g., "/1", "/2"
-
-  //Serial.print("Loading patch file: ");
-  //Serial.println(filename);
-
-  File patchFile = SD.open(filename);
-  if (!patchFile) {
-    //Serial.print("Patch file not found: ");
-    //Serial.println(filename);
-  } else {
-    String data[NO_OF_PARAMS];
-    recallPatchData(patchFile, data);
-    setCurrentPatchData(data);
-    patchFile.close();
-    //Serial.println("Patch data loaded successfully.");
+  recallPatchFlag = true;
+  if (!sendingSysEx && updateParams) {
+    startRecallTiming(patchNo);
+    if (recallSysEx && stored) {
+      sendPatchSysEx(rec);
+    } else {
+      sendToSynthData();
+    }
   }
-
   recallPatchFlag = false;
 }
 
-
-void setCurrentPatchData(String data[]) {
-  patchName = data[0];
-  osc1_octave = data[1].toInt();
-  osc1_wave = data[2].toInt();
-  osc1_pwm = data[3].toInt();
-  vca_gate = data[4].toInt();
-  osc2_octave = data[5].toInt();
-  osc2_detune = data[6].toInt();
-  osc2_wave = data[7].toInt();
-  osc2_interval = data[8].toInt();
-  vcf_cutoff = data[9].toInt();
-  vcf_res = data[10].toInt();
-  vcf_eg_depth = data[11].toInt();
-  vcf_key_follow = data[12].toInt();
-  lfo1_speed = data[13].toInt();
-  lfo1_delay = data[14].toInt();
-  lfo1_wave = data[15].toInt();
-  lfo_src = data[16].toInt();
-  eg1_attack = data[17].toInt();
-  eg1_decay = data[18].toInt();
-  eg1_sustain = data[19].toInt();
-  eg1_release = data[20].toInt();
-  lfo2_speed = data[21].toInt();
-  lfo2_wave = data[22].toInt();
-  key_rotate = data[23].toInt();
-  lfo1_vcf = data[24].toInt();
-  lfo1_vco = data[25].toInt();
+void setCurrentPatchData(const PatchRecord &rec) {
+  decodePatch(rec.packed);
+  osc2_wave |= (rec.ext & PATCH_EXT_OSC2_WAVE_HI) ? 4 : 0;
+  key_rotate = (rec.ext & PATCH_EXT_KEY_ROTATE) ? 1 : 0;
+  patchName = rec.name;
 
   //Patchname
   updatePatchname();
 
   //Serial.print("Set Patch: ");
   //Serial.println(patchName);
-  if (!sendingSysEx) {
-    if (updateParams) {
-      sendToSynthData();
-    }
-  }
+}
+
+// Sends a recalled patch as one 0x02 message straight from its stored bytes. The CC mirror is
+// brought up to date without sending, except for the two parameters the format can't carry:
+// the high bit of the wave and key rotate always go as CCs, queued behind the SysEx so it
+// can't overwrite them.
+void sendPatchSysEx(const PatchRecord &rec) {
+  byte msg[SYX_NAMED_PATCH_LEN];
+  syxBuildNamedPatch(msg, SYX_SINGLE, rec);
+  midiPort.beginReplaceable();  // A recall still waiting to go out is dropped, with its CCs
+  MIDI.sendSysEx(sizeof(msg), msg, true);
+
+  if (!ccMirrorValid) forgetSentCCs();
+  ccMirrorOnly = true;
+  sendToSynthData();
+  ccMirrorOnly = false;
+  ccMirror[CCosc2_wave] = CC_UNSENT;
+  ccMirror[CCkey_rotate] = CC_UNSENT;
+  midiPort.sendCCsAfterSysEx(true);
+  updateosc2_wave();
+  updatekey_rotate();
+  midiPort.sendCCsAfterSysEx(false);
+  midiPort.endReplaceable();
+}
+
+// Time to sound: from handing a recall to the MIDI port until its last byte is on the wire
+void startRecallTiming(int patchNo) {
+#if DEBUG_CHECKS
+  recallTimedPatch = patchNo;
+  recallTimedAt = micros();
+  recallTimedBytes = midiOutQueued(RECALL_LANES);
+#endif
+}
+
+// Logs the time to sound once the recall being timed is on the wire, called from loop()
+void serviceRecallTiming() {
+#if DEBUG_CHECKS
+  if (!recallTimedAt || !midiOutIdle(RECALL_LANES)) return;
+  Serial.println("Recall of patch " + String(recallTimedPatch) + " via " + (recallSysEx ? "SysEx: " : "CC: ")
+                 + String(midiOutQueued(RECALL_LANES) - recallTimedBytes) + " bytes, " + String(micros() - recallTimedAt) + "us to sound");
+  recallTimedAt = 0;
+#endif
 }
 
 void sendToSynthData() {
@@ -1474,24 +1506,84 @@ void sendToSynthData() {
   updatekey_rotate();
 }
 
-String getCurrentPatchData() {
-  return patchName + "," + String(osc1_octave) + "," + String(osc1_wave) + "," + String(osc1_pwm) + "," + String(vca_gate)
-         + "," + String(osc2_octave) + "," + String(osc2_detune) + "," + String(osc2_wave) + "," + String(osc2_interval)
-         + "," + String(vcf_cutoff) + "," + String(vcf_res) + "," + String(vcf_eg_depth) + "," + String(vcf_key_follow)
-         + "," + String(lfo1_speed) + "," + String(lfo1_delay) + "," + String(lfo1_wave) + "," + String(lfo_src)
-         + "," + String(eg1_attack) + "," + String(eg1_decay) + "," + String(eg1_sustain) + "," + String(eg1_release)
-         + "," + String(lfo2_speed) + "," + String(lfo2_wave) + "," + String(key_rotate) + "," + String(lfo1_vcf) + "," + String(lfo1_vco);
+// Packs the current patch into a bank record
+void getCurrentPatchData(PatchRecord &rec) {
+  memset(&rec, 0, sizeof(rec));
+  rec.flags = PATCH_FLAG_USED;
+  encodePatch(0, rec.packed);
+  if (osc2_wave & 0x04) rec.ext |= PATCH_EXT_OSC2_WAVE_HI;
+  if (key_rotate) rec.ext |= PATCH_EXT_KEY_ROTATE;
+  strncpy(rec.name, patchName.c_str(), PATCH_NAME_LEN);
+}
+
+void savePatch(int patchNo) {
+  PatchRecord rec;
+  getCurrentPatchData(rec);
+  writePatchRecord(patchNo, rec);
+}
+
+// Saves a patch received in a bank unless the Duplicates setting leaves out sounds already
+// stored. The decoded parameters are packed again first so the comparison sees the bytes
+// savePatch() would store.
+bool saveImportedPatch(int patchNo) {
+  byte packed[PATCH_BYTES];
+  encodePatch(0, packed);
+  if (skipDuplicateSound(packed, patchNo)) return false;
+  savePatch(patchNo);
+  return true;
+}
+
+// Every patch parameter, in the legacy CSV field order. Used to migrate old patch files and
+// as the edit journal's parameter numbering, so the order must not change.
+int *const patchParams[PATCH_CSV_FIELDS] = {
+  &osc1_octave, &osc1_wave, &osc1_pwm, &vca_gate, &osc2_octave, &osc2_detune, &osc2_wave, &osc2_interval,
+  &vcf_cutoff, &vcf_res, &vcf_eg_depth, &vcf_key_follow, &lfo1_speed, &lfo1_delay, &lfo1_wave, &lfo_src,
+  &eg1_attack, &eg1_decay, &eg1_sustain, &eg1_release, &lfo2_speed, &lfo2_wave, &key_rotate, &lfo1_vcf, &lfo1_vco
+};
+
+void patchRecordFromCsv(const PatchCsvRecord &csv, PatchRecord &rec) {
+  patchName = csv.name;
+  for (int i = 0; i < PATCH_CSV_FIELDS; i++) {
+    *patchParams[i] = csv.values[i];
+  }
+  getCurrentPatchData(rec);
 }
 
 void showSettingsPage() {
   showSettingsPage(settings::current_setting(), settings::current_setting_value(), state);
 }
 
+void forgetSentCCs() {
+  memset(ccMirror, CC_UNSENT, sizeof(ccMirror));
+  ccMirrorValid = true;
+}
+
 void midiCCOut(byte cc, byte value) {
-  MIDI.sendControlChange(cc, value, midiOutCh);  //MIDI DIN is set to Out
-  if (updateParams) {
-    delay(3);
-  }
+  if (!ccMirrorValid) forgetSentCCs();
+  if (ccMirror[cc] == value) return;  // The synth has it already
+  ccMirror[cc] = value;
+  if (ccMirrorOnly) return;
+  MIDI.sendControlChange(cc, value, midiOutCh);  //MIDI DIN is set to Out, paced by the param lane
+}
+
+// Sends every parameter whether the synth should have it or not
+void resendToSynthData() {
+  forgetSentCCs();
+  recallPatchFlag = true;
+  sendToSynthData();
+  recallPatchFlag = false;
+}
+
+// Runs the full resend chosen in the settings menu
+void checkSynthResync() {
+  if (!synthResyncRequest) return;
+  synthResyncRequest = false;
+  resendToSynthData();
+  settings::decrement_setting_value();
+  settings::save_current_value();
+  showCurrentParameterPage("Resync", String("Sent all"));
+  state = PARAMETER;
+  startParameterDisplay();
 }
 
 void checkSwitches() {
@@ -1508,22 +1600,21 @@ void checkSwitches() {
   } else if (saveButton.numClicks() == 1) {
     switch (state) {
       case PARAMETER:
-        if (patches.size() < PATCHES_LIMIT) {
-          resetPatchesOrdering();  //Reset order of patches from first patch
-          patches.push({ patches.size() + 1, INITPATCHNAME });
+        if (addPendingPatch()) {  //New patch after the last one, cursor on it
           state = SAVE;
         }
         refreshScreen();
         break;
       case SAVE:
         //Save as new patch with INITIALPATCH name or overwrite existing keeping name - bypassing patch renaming
-        patchName = patches.last().patchName;
+        patchName = patchNameAt(0);
         state = PATCH;
-        savePatch(String(patches.last().patchNo).c_str(), getCurrentPatchData());
-        showPatchPage(String(patches.last().patchNo), patches.last().patchName);
-        patchNo = patches.last().patchNo;
-        loadPatches();  //Get rid of pushed patch if it wasn't saved
-        setPatchesOrdering(patchNo);
+        patchNo = patchNoAt(0);
+        savePatch(patchNo);
+        startEditJournal(patchNo);  //Edits from here on apply to the saved patch
+        showPatchPage(String(patchNo), patchName);
+        indexPatch(patchNo);  //Add or re-sort it in the patch list
+        selectPatch(patchNo);
         renamedPatch = "";
         state = PARAMETER;
         refreshScreen();
@@ -1531,11 +1622,12 @@ void checkSwitches() {
       case PATCHNAMING:
         if (renamedPatch.length() > 0) patchName = renamedPatch;  //Prevent empty strings
         state = PATCH;
-        savePatch(String(patches.last().patchNo).c_str(), getCurrentPatchData());
-        showPatchPage(String(patches.last().patchNo), patchName);
-        patchNo = patches.last().patchNo;
-        loadPatches();  //Get rid of pushed patch if it wasn't saved
-        setPatchesOrdering(patchNo);
+        patchNo = patchNoAt(0);
+        savePatch(patchNo);
+        startEditJournal(patchNo);  //Edits from here on apply to the saved patch
+        showPatchPage(String(patchNo), patchName);
+        indexPatch(patchNo);  //Add or re-sort it in the patch list
+        selectPatch(patchNo);
         renamedPatch = "";
         state = PARAMETER;
         refreshScreen();
@@ -1557,6 +1649,14 @@ void checkSwitches() {
         showSettingsPage();
         refreshScreen();
         break;
+      case RECALL:
+        //Choose a first character and jump to the first patch name starting with it
+        charIndex = 0;
+        currentCharacter = CHARACTERS[charIndex];
+        selectPatch(findPatchPrefix(currentCharacter));
+        state = PATCHJUMP;
+        refreshScreen();
+        break;
       case SETTINGS:
         showSettingsPage();
         refreshScreen();
@@ -1575,15 +1675,15 @@ void checkSwitches() {
   } else if (backButton.numClicks() == 1) {
     switch (state) {
       case RECALL:
-        setPatchesOrdering(patchNo);
+        selectPatch(patchNo);
         state = PARAMETER;
         refreshScreen();
         break;
       case SAVE:
         renamedPatch = "";
         state = PARAMETER;
-        loadPatches();  //Remove patch that was to be saved
-        setPatchesOrdering(patchNo);
+        cancelPendingPatch();  //Remove patch that was to be saved
+        selectPatch(patchNo);
         refreshScreen();
         break;
       case PATCHNAMING:
@@ -1592,8 +1692,13 @@ void checkSwitches() {
         state = SAVE;
         refreshScreen();
         break;
+      case PATCHJUMP:
+        selectPatch(patchNo);
+        state = RECALL;
+        refreshScreen();
+        break;
       case DELETE:
-        setPatchesOrdering(patchNo);
+        selectPatch(patchNo);
         state = PARAMETER;
         refreshScreen();
         break;
@@ -1616,7 +1721,7 @@ void checkSwitches() {
     //which clears any changes made
     state = PATCH;
     //Recall the current patch
-    patchNo = patches.first().patchNo;
+    patchNo = patchNoAt(0);
     recallPatch(patchNo);
     state = PARAMETER;
     refreshScreen();
@@ -1627,16 +1732,17 @@ void checkSwitches() {
         refreshScreen();
         break;
       case RECALL:
+      case PATCHJUMP:
         state = PATCH;
         //Recall the current patch
-        patchNo = patches.first().patchNo;
+        patchNo = patchNoAt(0);
         recallPatch(patchNo);
         state = PARAMETER;
         refreshScreen();
         break;
       case SAVE:
-        showRenamingPage(patches.last().patchName);
-        patchName = patches.last().patchName;
+        showRenamingPage(patchNameAt(0));
+        patchName = patchNameAt(0);
         state = PATCHNAMING;
         refreshScreen();
         break;
@@ -1652,15 +1758,18 @@ void checkSwitches() {
         break;
       case DELETE:
         //Don't delete final patch
-        if (patches.size() > 1) {
+        if (patchCount > 1) {
           state = DELETEMSG;
-          patchNo = patches.first().patchNo;  //PatchNo to delete from SD card
-          patches.shift();                    //Remove patch from circular buffer
-          deletePatch(patchNo);               //Delete from SD card
-          loadPatches();                      //Repopulate circular buffer to start from lowest Patch No
-          renumberPatchesOnSD();
-          loadPatches();                      //Repopulate circular buffer again after delete
-          patchNo = patches.first().patchNo;  //Go back to 1
+          patchNo = patchNoAt(0);  //PatchNo to delete
+          deletePatch(patchNo);    //Drop it from the slot map, later patches move down one
+          unindexPatch(patchNo);   //And from the patch list
+#if DEBUG_CHECKS
+          checkPatchIndex();
+#endif
+          editJournalPatchDeleted(patchNo);
+          lastPatchDeleted(patchNo);
+          patchCursor = 0;
+          patchNo = patchNoAt(0);  //Go back to 1
           recallPatch(patchNo);               //Load first patch
         }
         state = PARAMETER;
@@ -1713,9 +1822,7 @@ void reinitialiseToPanel() {
   vca_gate = 1;
   key_rotate = 0;
 
-  recallPatchFlag = true;
-  sendToSynthData();
-  recallPatchFlag = false;
+  resendToSynthData();
 }
 
 void checkEncoder() {
@@ -1729,16 +1836,12 @@ void checkEncoder() {
 
     switch (state) {
       case PARAMETER:
-        if (!patches.isEmpty()) {
+        if (patchListSize() > 0) {
           state = PATCH;
 
-          if (goingUp) {
-            patches.push(patches.shift());
-          } else {
-            patches.unshift(patches.pop());
-          }
+          movePatchCursor(goingUp ? 1 : -1);
 
-          patchNo = patches.first().patchNo;
+          patchNo = patchNoAt(0);
           if (patchNo > 0) {
             //Serial.printf("Recalling patch #%d from encoder\n", patchNo);
             recallPatch(patchNo);
@@ -1749,19 +1852,15 @@ void checkEncoder() {
           state = PARAMETER;
           refreshScreen();
         } else {
-          //Serial.println("⚠️ patches buffer is empty in PARAMETER state!");
+          //Serial.println("⚠️ patch list is empty in PARAMETER state!");
         }
         break;
 
       case RECALL:
       case SAVE:
       case DELETE:
-        if (!patches.isEmpty()) {
-          if (goingUp) {
-            patches.push(patches.shift());
-          } else {
-            patches.unshift(patches.pop());
-          }
+        if (patchListSize() > 0) {
+          movePatchCursor(goingUp ? 1 : -1);
           refreshScreen();
         }
         break;
@@ -1777,6 +1876,20 @@ void checkEncoder() {
         refreshScreen();
         break;
 
+      case PATCHJUMP:
+        //Names are matched ignoring case, so only step through the lower case letters
+        do {
+          if (goingUp) {
+            if (++charIndex >= TOTALCHARS) charIndex = 0;
+          } else {
+            if (--charIndex < 0) charIndex = TOTALCHARS - 1;
+          }
+        } while (isupper(CHARACTERS[charIndex]));
+        currentCharacter = CHARACTERS[charIndex];
+        selectPatch(findPatchPrefix(currentCharacter));
+        refreshScreen();
+        break;
+
       case SETTINGS:
         if (goingUp)
           settings::increment_setting();
@@ -1804,25 +1917,24 @@ void checkLoadFactory() {
   if (loadFactory) {
     showCurrentParameterPage("Loading", String("Factory Patch"));
     startParameterDisplay();
+    importDuplicates = 0;
+    beginPatchBatch(loadPatches);
     for (int row = 0; row < 80; row++) {
-      String name;
-      uint8_t patchBytes[12];
-
-      // Convert one factory patch string into name + 12 bytes
-      parseFactoryPatch(row, name, patchBytes);
+      FactoryPatch factory;
+      memcpy_P(&factory, &factoryPatches[row], sizeof(factory));
 
       // Decode into synth parameters
-      decodePatch(patchBytes);
+      decodePatch(factory.packed);
 
-      patchName = name;  // Store name in slot 0}
+      patchName = factory.name;
 
-      sprintf(buffer, "%d", row + 1);
-      savePatch(buffer, getCurrentPatchData());
+      saveImportedPatch(row + 1);
       updatePatchname();
       //Serial.printf("Factory patch %02d saved as %s\n", row + 1, name.c_str());
     }
 
-    loadPatches();  // Refresh patch list
+    endPatchBatch();  // Write the bank out and refresh the patch list
+    reportImportDuplicates();
     loadFactory = false;
     storeLoadFactory(loadFactory);
 
@@ -1830,51 +1942,12 @@ void checkLoadFactory() {
     settings::decrement_setting_value();
     settings::save_current_value();
     showSettingsPage();
-    delay(100);
     state = PARAMETER;
     recallPatch(1);
     startParameterDisplay();
   }
 }
 
-void parseFactoryPatch(int row, String &name, uint8_t patchBytes[12]) {
-  // Get one row of the factorynibbles table
-  String line = factorynibbles[row];
-
-  // Split by commas
-  int valuesCount = 0;
-  String parts[30];  // plenty of room (1 name + 24 nibbles)
-
-  int start = 0;
-  for (int i = 0; i < line.length(); i++) {
-    if (line.charAt(i) == ',') {
-      parts[valuesCount++] = line.substring(start, i);
-      start = i + 1;
-    }
-  }
-  // Add last value
-  if (start < line.length()) {
-    parts[valuesCount++] = line.substring(start);
-  }
-
-  // First entry = patch name (trim spaces)
-  name = parts[0];
-  name.trim();
-
-  // Next 24 entries = nibbles
-  uint8_t nibbles[24];
-  for (int i = 0; i < 24; i++) {
-    String s = parts[i + 1];
-    s.trim();
-    nibbles[i] = (uint8_t)strtol(s.c_str(), NULL, 16);  // parse hex
-  }
-
-  // Pack nibbles into 12 bytes
-  for (int b = 0; b < 12; b++) {
-    patchBytes[b] = ((nibbles[b * 2] & 0x0F) << 4) | (nibbles[b * 2 + 1] & 0x0F);
-  }
-}
-
 void RotaryEncoderChanged(bool clockwise, int id) {
 
   if (!accelerate) {
@@ -2113,34 +2186,36 @@ void pollAllMCPs() {
 
 void loop() {
 
-  if (!recallPatchFlag) {
+  while (midiPort.available()) {  // read() parses a byte per call and is false until a message completes
     MIDI.read(midiChannel);
   }
 
-  if (!receivingSysEx) {
+  pollAllMCPs();
+  checkSwitches();
+  checkEncoder();
 
-    pollAllMCPs();
-    checkSwitches();
-    checkEncoder();
+  if (!receivingSysEx) {  // Bulk jobs wait for a dump coming in to finish
     checkLoadFactory();
+    checkSyxTransfer();
+    checkPatchPage();
+    checkSynthResync();
     sendSinglePatch(patchNo);
     sendBankDump();
     sendSysexDump();
   }
 
+  servicePatchBatch();
+  checkLastPatch();
+  serviceEditJournal();
+  servicePatchFlash();
+  serviceStorage();
+  reportMidiOut();
+  reportMidiIn();
+  serviceRecallTiming();
+  serviceBankSend();
+
   if (waitingToUpdate && (millis() - lastDisplayTriggerTime >= displayTimeout)) {
     refreshScreen();  // retrigger
     waitingToUpdate = false;
   }
-
-  if (sysexComplete) {
-    sysexComplete = false;  // Reset for the next SysEx message
-    showCurrentParameterPage("Processing", String("Sysex Dump"));
-    startParameterDisplay();
-    convertNibblesToBytes();
-    decodePatches();
-    currentBlock = 0;  // Reset to start filling from block 0 again
-    byteIndex = 0;     // Reset byte index within the block
-    receivingSysEx = false;
-  }
 }
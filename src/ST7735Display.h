@@ -178,17 +178,17 @@ void renderDeletePatchPage() {
   tft.setFont(&FreeSans9pt7b);
   tft.setCursor(0, 58);
   tft.setTextColor(ST7735_YELLOW);
-  tft.println(patches.last().patchNo);
+  tft.println(patchNoAt(-1));
   tft.setCursor(35, 58);
   tft.setTextColor(ST7735_WHITE);
-  tft.println(patches.last().patchName);
+  tft.println(patchNameAt(-1));
   tft.fillRect(0, 65, tft.width(), 23, ST77XX_RED);
   tft.setCursor(0, 78);
   tft.setTextColor(ST7735_YELLOW);
-  tft.println(patches.first().patchNo);
+  tft.println(patchNoAt(0));
   tft.setCursor(35, 78);
   tft.setTextColor(ST7735_WHITE);
-  tft.println(patches.first().patchName);
+  tft.println(patchNameAt(0));
 }
 
 void renderDeleteMessagePage() {
@@ -224,17 +224,17 @@ void renderSavePage() {
   tft.setFont(&FreeSans9pt7b);
   tft.setCursor(0, 58);
   tft.setTextColor(ST7735_YELLOW);
-  tft.println(patches[patches.size() - 2].patchNo);
+  tft.println(patchNoAt(-1));
   tft.setCursor(35, 58);
   tft.setTextColor(ST7735_WHITE);
-  tft.println(patches[patches.size() - 2].patchName);
+  tft.println(patchNameAt(-1));
   tft.fillRect(0, 65, tft.width(), 23, ST77XX_RED);
   tft.setCursor(0, 78);
   tft.setTextColor(ST7735_YELLOW);
-  tft.println(patches.last().patchNo);
+  tft.println(patchNoAt(0));
   tft.setCursor(35, 78);
   tft.setTextColor(ST7735_WHITE);
-  tft.println(patches.last().patchName);
+  tft.println(patchNameAt(0));
 }
 
 void renderReinitialisePage() {
@@ -266,25 +266,30 @@ void renderRecallPage() {
   tft.setFont(&FreeSans9pt7b);
   tft.setCursor(0, 25);
   tft.setTextColor(ST7735_YELLOW);
-  tft.println(patches.last().patchNo);
+  tft.println(patchNoAt(-1));
   tft.setCursor(35, 25);
   tft.setTextColor(ST7735_WHITE);
-  tft.println(patches.last().patchName);
+  tft.println(patchNameAt(-1));
 
   tft.fillRect(0, 36, tft.width(), 23, 0xA000);
   tft.setCursor(0, 52);
   tft.setTextColor(ST7735_YELLOW);
-  tft.println(patches.first().patchNo);
+  tft.println(patchNoAt(0));
   tft.setCursor(35, 52);
   tft.setTextColor(ST7735_WHITE);
-  tft.println(patches.first().patchName);
+  tft.println(patchNameAt(0));
+  if (state == PATCHJUMP) {
+    tft.setCursor(145, 52);
+    tft.setTextColor(ST7735_YELLOW);
+    tft.println((char)toupper(currentCharacter));
+  }
 
   tft.setCursor(0, 78);
   tft.setTextColor(ST7735_YELLOW);
-  patches.size() > 1 ? tft.println(patches[1].patchNo) : tft.println(patches.last().patchNo);
+  tft.println(patchNoAt(1));
   tft.setCursor(35, 78);
   tft.setTextColor(ST7735_WHITE);
-  patches.size() > 1 ? tft.println(patches[1].patchName) : tft.println(patches.last().patchName);
+  tft.println(patchNameAt(1));
 }
 
 void showRenamingPage(String newName) {
@@ -356,6 +361,7 @@ void refreshScreen() {
         }
         break;
       case RECALL:
+      case PATCHJUMP:
         renderRecallPage();
         break;
       case SAVE:
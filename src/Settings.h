@@ -11,6 +11,14 @@ void settingsAfterTouch();
 void settingsSaveAll();
 void settingsSaveCurrent();
 void settingsSaveEditorAll();
+void settingsBrowseBy();
+void settingsSyxImport();
+void settingsSyxExport();
+void settingsPatchPage();
+void settingsDuplicates();
+void settingsResync();
+void settingsRecallVia();
+void settingsSysExGap();
 
 int currentIndexMIDICh();
 int currentIndexMIDIOutCh();
@@ -23,6 +31,14 @@ int currentIndexAfterTouch();
 int currentIndexSaveAll();
 int currentIndexSaveCurrent();
 int currentIndexSaveEditorAll();
+int currentIndexBrowseBy();
+int currentIndexSyxImport();
+int currentIndexSyxExport();
+int currentIndexPatchPage();
+int currentIndexDuplicates();
+int currentIndexResync();
+int currentIndexRecallVia();
+int currentIndexSysExGap();
 
 void settingsMIDICh(int index, const char *value) {
   if (strcmp(value, "ALL") == 0) {
@@ -40,6 +56,7 @@ void settingsMIDIOutCh(int index, const char *value) {
     midiOutCh = atoi(value);
   }
   storeMidiOutCh(midiOutCh);
+  ccMirrorValid = false;
 }
 
 void settingsEncoderDir(int index, const char *value) {
@@ -123,6 +140,45 @@ void settingsSaveEditorAll(int index, const char *value) {
   storeSaveAll(saveEditorAll);
 }
 
+void settingsBrowseBy(int index, const char *value) {
+  setPatchViewByName(strcmp(value, "Name") == 0);
+  storeBrowseByName(patchViewByName);
+}
+
+// Import offers Bank and Library, export also Patch
+void settingsSyxImport(int index, const char *value) {
+  syxImport = index ? index + 1 : 0;
+}
+
+void settingsSyxExport(int index, const char *value) {
+  syxExport = index;
+}
+
+void settingsPatchPage(int index, const char *value) {
+  if (index != patchPage) patchPageRequest = index;
+}
+
+void settingsDuplicates(int index, const char *value) {
+  importSkipDuplicates = strcmp(value, "Skip") == 0;
+  storeSkipDuplicates(importSkipDuplicates);
+}
+
+void settingsResync(int index, const char *value) {
+  synthResyncRequest = strcmp(value, "Yes") == 0;
+}
+
+void settingsRecallVia(int index, const char *value) {
+  recallSysEx = strcmp(value, "SysEx") == 0;
+  storeRecallSysEx(recallSysEx);
+}
+
+const byte sysExGapValues[] = { 0, 1, 2, 5, 10, 20 };
+
+void settingsSysExGap(int index, const char *value) {
+  midiSysExGapUs = atoi(value) * 1000;
+  storeSysExGap(atoi(value));
+}
+
 int currentIndexMIDICh() {
   return getMIDIChannel();
 }
@@ -167,6 +223,42 @@ int currentIndexAfterTouch() {
   return getAfterTouch() ? 1 : 0;
 }
 
+int currentIndexBrowseBy() {
+  return getBrowseByName() ? 1 : 0;
+}
+
+int currentIndexSyxImport() {
+  return syxImport ? syxImport - 1 : 0;
+}
+
+int currentIndexSyxExport() {
+  return syxExport;
+}
+
+int currentIndexPatchPage() {
+  return patchPage;
+}
+
+int currentIndexDuplicates() {
+  return getSkipDuplicates() ? 1 : 0;
+}
+
+int currentIndexResync() {
+  return 0;
+}
+
+int currentIndexRecallVia() {
+  return getRecallSysEx() ? 1 : 0;
+}
+
+int currentIndexSysExGap() {
+  byte gap = getSysExGap();
+  for (int i = sizeof(sysExGapValues) - 1; i > 0; i--) {
+    if (gap >= sysExGapValues[i]) return i;
+  }
+  return 0;
+}
+
 // add settings to the circular buffer
 void setUpSettings() {
   settings::append(settings::SettingsOption{"MIDI Ch.", {"All", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "11", "12", "13", "14", "15", "16", "\0"}, settingsMIDICh, currentIndexMIDICh});
@@ -180,4 +272,12 @@ void setUpSettings() {
   settings::append(settings::SettingsOption{"Send to 61", {"No", "Yes", "\0"}, settingsSaveAll, currentIndexSaveAll});
   settings::append(settings::SettingsOption{"Send Patch", {"No", "Yes", "\0"}, settingsSaveCurrent, currentIndexSaveCurrent});
   settings::append(settings::SettingsOption{"Send All", {"No", "Yes", "\0"}, settingsSaveEditorAll, currentIndexSaveEditorAll});
+  settings::append(settings::SettingsOption{"Browse By", {"Number", "Name", "\0"}, settingsBrowseBy, currentIndexBrowseBy});
+  settings::append(settings::SettingsOption{"Syx Import", {"No", "Bank", "Library", "\0"}, settingsSyxImport, currentIndexSyxImport});
+  settings::append(settings::SettingsOption{"Syx Export", {"No", "Patch", "Bank", "Library", "\0"}, settingsSyxExport, currentIndexSyxExport});
+  settings::append(settings::SettingsOption{"Patch Page", {"1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "11", "12", "13", "14", "15", "16", "17", "18", "19", "20", "21", "22", "23", "24", "25", "26", "27", "28", "29", "30", "31", "32", "\0"}, settingsPatchPage, currentIndexPatchPage});
+  settings::append(settings::SettingsOption{"Duplicates", {"Import", "Skip", "\0"}, settingsDuplicates, currentIndexDuplicates});
+  settings::append(settings::SettingsOption{"Resync 61", {"No", "Yes", "\0"}, settingsResync, currentIndexResync});
+  settings::append(settings::SettingsOption{"Recall Via", {"CC", "SysEx", "\0"}, settingsRecallVia, currentIndexRecallVia});
+  settings::append(settings::SettingsOption{"SysEx Gap", {"0", "1", "2", "5", "10", "20", "\0"}, settingsSysExGap, currentIndexSysExGap});
 }
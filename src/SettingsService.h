@@ -13,8 +13,8 @@
 
 #pragma once
 
-#define SETTINGSOPTIONSNO 11 //No of options
-#define SETTINGSVALUESNO 18 //Maximum number of settings option values needed
+#define SETTINGSOPTIONSNO 19 //No of options
+#define SETTINGSVALUESNO 33 //Maximum number of settings option values needed
 
 namespace settings {
 
@@ -0,0 +1,254 @@
+// SysEx files
+// Banks are moved in and out as .syx files under /syx in the same formats the editor speaks
+// over MIDI: 0x31 (80 unnamed patches in one message), 0x02 (one named patch) and 0x03 (one
+// named patch of a bank, one message per patch). Files are streamed SYX_CHUNK bytes at a time
+// through a byte-fed decoder and a buffered writer, so no file is ever held in RAM whole.
+#define SYX_DIR "/syx"
+#define SYX_LIBRARY_FILE SYX_DIR "/LIBRARY.SYX"
+#define SYX_CHUNK 512
+#define SYX_NAME_NIBBLES (PATCH_NAME_LEN * 2)
+
+#define SYX_BANK 0x31        // 80 patches without names
+#define SYX_SINGLE 0x02      // One patch with name
+#define SYX_BANK_NAMED 0x03  // One patch with name, sent 80 times for a bank
+
+const byte syxHeader[HEADER_BYTES - 1] = { 0xF0, 0x42, 0x50, 0x36 };  // Followed by the type byte
+
+// Called for every patch the decoder completes, name is nullptr for SYX_BANK
+typedef void (*SyxPatchHandler)(byte type, int index, const char *name, const byte *packed);
+
+struct SyxDecoder
+{
+  SyxPatchHandler onPatch;
+  bool inMessage;
+  byte headerPos;
+  byte type;
+  int nibble;  // Position within the current patch
+  int index;   // Patch within the current message
+  byte hi;
+  char name[PATCH_NAME_LEN + 1];
+  byte packed[PATCH_BYTES];
+};
+
+void syxBegin(SyxDecoder &d, SyxPatchHandler onPatch) {
+  memset(&d, 0, sizeof(d));
+  d.onPatch = onPatch;
+}
+
+// Feeds one byte of a SysEx stream, any number of messages back to back
+void syxFeed(SyxDecoder &d, byte b) {
+  if (b == 0xF0) {
+    d.inMessage = true;
+    d.headerPos = 1;
+    d.nibble = 0;
+    d.index = 0;
+    return;
+  }
+  if (b == 0xF7) {
+    d.inMessage = false;  // A partial patch is dropped
+    return;
+  }
+  if (b & 0x80 || !d.inMessage) return;  // Realtime bytes, or outside a message
+
+  if (d.headerPos < HEADER_BYTES) {
+    if (d.headerPos < HEADER_BYTES - 1) {
+      d.inMessage = b == syxHeader[d.headerPos];
+    } else {
+      d.type = b;
+      d.inMessage = b == SYX_BANK || b == SYX_SINGLE || b == SYX_BANK_NAMED;
+    }
+    d.headerPos++;
+    return;
+  }
+
+  int nameNibbles = d.type == SYX_BANK ? 0 : SYX_NAME_NIBBLES;
+  if (!(d.nibble & 1)) {
+    d.hi = b;
+  } else {
+    int pos = d.nibble / 2;
+    byte value = ((d.hi & 0x0F) << 4) | (b & 0x0F);
+    if (pos < nameNibbles / 2) {
+      d.name[pos] = value;
+    } else {
+      d.packed[pos - nameNibbles / 2] = value;
+    }
+  }
+  if (++d.nibble == nameNibbles + PATCH_NIBBLES) {
+    d.name[PATCH_NAME_LEN] = '\0';
+    d.onPatch(d.type, d.index++, nameNibbles ? d.name : nullptr, d.packed);
+    d.nibble = 0;
+  }
+}
+
+// Buffered writer, the output (a file, or the MIDI port's SysEx lane) sees SYX_CHUNK byte writes
+struct SyxWriter
+{
+  Print *out;
+  byte buf[SYX_CHUNK];
+  int len;
+  bool ok;
+};
+
+void syxFlush(SyxWriter &w) {
+  if (w.len && w.out->write(w.buf, w.len) != (size_t)w.len) w.ok = false;
+  w.len = 0;
+}
+
+void syxPut(SyxWriter &w, byte b) {
+  w.buf[w.len++] = b;
+  if (w.len == SYX_CHUNK) syxFlush(w);
+}
+
+void syxPutHeader(SyxWriter &w, byte type) {
+  for (byte b : syxHeader) syxPut(w, b);
+  syxPut(w, type);
+}
+
+// Each byte as a high and a low nibble
+void syxPutNibbles(SyxWriter &w, const byte *src, int len) {
+  for (int i = 0; i < len; i++) {
+    syxPut(w, (src[i] >> 4) & 0x0F);
+    syxPut(w, src[i] & 0x0F);
+  }
+}
+
+// One named patch message (SYX_SINGLE or SYX_BANK_NAMED)
+void syxPutNamedPatch(SyxWriter &w, byte type, const PatchRecord &rec) {
+  char name[PATCH_NAME_LEN];
+  strncpy(name, rec.name, PATCH_NAME_LEN);  // Pads short names with NULs
+  syxPutHeader(w, type);
+  syxPutNibbles(w, (const byte *)name, PATCH_NAME_LEN);
+  syxPutNibbles(w, rec.packed, PATCH_BYTES);
+  syxPut(w, 0xF7);
+}
+
+#define SYX_NAMED_PATCH_LEN (HEADER_BYTES + SYX_NAME_NIBBLES + PATCH_NIBBLES + 1)
+
+// One named patch message built in memory for sending over MIDI, SYX_NAMED_PATCH_LEN bytes
+void syxBuildNamedPatch(byte *msg, byte type, const PatchRecord &rec) {
+  static SyxWriter w;
+  w = { nullptr, {}, 0, true };  // Never reaches SYX_CHUNK, so it is never flushed
+  syxPutNamedPatch(w, type, rec);
+  memcpy(msg, w.buf, w.len);
+}
+
+// Patches start..start+79 as one SYX_BANK message, packed straight from the stored records.
+// Empty slots go out as all zeros.
+void syxPutBank(SyxWriter &w, int start) {
+  static const byte empty[PATCH_BYTES] = {};
+  syxPutHeader(w, SYX_BANK);
+  for (int p = 0; p < NUM_PATCHES; p++) {
+    const PatchRecord *rec = getPatchRecord(start + p);
+    syxPutNibbles(w, rec ? rec->packed : empty, PATCH_BYTES);
+  }
+  syxPut(w, 0xF7);
+}
+
+int syxImportStart = 1;
+int syxImported = 0;
+
+void syxImportPatch(byte type, int index, const char *name, const byte *packed) {
+  int patchNo = syxImportStart + syxImported;
+  if (patchNo > PATCHES_LIMIT || skipDuplicateSound(packed, patchNo)) return;
+
+  PatchRecord rec = {};
+  rec.flags = PATCH_FLAG_USED;
+  memcpy(rec.packed, packed, PATCH_BYTES);
+  if (name) {
+    strncpy(rec.name, name, PATCH_NAME_LEN);
+  } else {
+    snprintf(rec.name, sizeof(rec.name), "Sysex %d", patchNo);
+  }
+  if (writePatchRecord(patchNo, rec)) syxImported++;
+}
+
+// Imports every patch in a .syx file, in file order, as patches start, start + 1, ...
+// Returns the number of patches imported.
+int importSyxFile(const char *path, int start) {
+  File file = SD.open(path, FILE_READ);
+  if (!file) {
+    Serial.print("Can't open ");
+    Serial.println(path);
+    return 0;
+  }
+
+  unsigned long started = millis();
+  byte buf[SYX_CHUNK];
+  SyxDecoder decoder;
+  syxBegin(decoder, syxImportPatch);
+  syxImportStart = start;
+  syxImported = 0;
+  importDuplicates = 0;
+  size_t total = 0;
+
+  beginPatchBatch(loadPatches);
+  while (true) {
+    int n = file.read(buf, sizeof(buf));
+    if (n <= 0) break;
+    for (int i = 0; i < n; i++) syxFeed(decoder, buf[i]);
+    total += n;
+  }
+  endPatchBatch();
+  file.close();
+
+  Serial.println("Imported " + String(syxImported) + " patches (" + String(total) + " bytes) from " + path + " in " + String(millis() - started) + "ms");
+  reportImportDuplicates();
+  return syxImported;
+}
+
+bool openSyxForWrite(const char *path, File &file) {
+  if (!SD.exists(SYX_DIR)) SD.mkdir(SYX_DIR);
+  if (SD.exists(path)) SD.remove(path);
+  file = SD.open(path, FILE_WRITE);
+  if (!file) {
+    Serial.print("Can't create ");
+    Serial.println(path);
+  }
+  return file;
+}
+
+// Patches start..start+79 as one SYX_BANK message, empty slots are sent as all zeros
+bool exportSyxBank(const char *path, int start) {
+  File file;
+  if (!openSyxForWrite(path, file)) return false;
+  unsigned long started = millis();
+  static SyxWriter w;
+  w = { &file, {}, 0, true };
+
+  syxPutBank(w, start);
+  syxFlush(w);
+  file.close();
+  Serial.println("Exported bank from patch " + String(start) + " to " + path + " in " + String(millis() - started) + "ms");
+  return w.ok;
+}
+
+// A single SYX_SINGLE message
+bool exportSyxPatch(const char *path, int patchNo) {
+  const PatchRecord *rec = getPatchRecord(patchNo);
+  if (!rec) return false;
+  File file;
+  if (!openSyxForWrite(path, file)) return false;
+  static SyxWriter w;
+  w = { &file, {}, 0, true };
+  syxPutNamedPatch(w, SYX_SINGLE, *rec);
+  syxFlush(w);
+  file.close();
+  return w.ok;
+}
+
+// Every stored patch in number order as SYX_BANK_NAMED messages, which importSyxFile()
+// reads back as patch 1 onwards
+bool exportSyxLibrary(const char *path) {
+  File file;
+  if (!openSyxForWrite(path, file)) return false;
+  unsigned long started = millis();
+  static SyxWriter w;
+  w = { &file, {}, 0, true };
+  for (int i = 0; i < patchCount; i++) {
+    syxPutNamedPatch(w, SYX_BANK_NAMED, *getPatchRecord(patchList[i]));
+  }
+  syxFlush(w);
+  file.close();
+  Serial.println("Exported " + String(patchCount) + " patches to " + path + " in " + String(millis() - started) + "ms");
+  return w.ok;
+}